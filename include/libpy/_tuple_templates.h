@@ -4,10 +4,26 @@
 /**
    Pack variadic arguments into a Python `tuple` object.
 
+   The tuple is filled directly, one store per element. `tmpref` arguments
+   passed as rvalues have their reference stolen, so
+   `pack(a + b, c)` does not incref or decref the result of `a + b`.
+
    @param elems The elements to pack.
    @return      The elements packed as a Python `tuple`.
 */
 template<typename... Ts>
-tmpref<object> pack(const Ts&... elems) {
-    return PyTuple_Pack(sizeof...(Ts), static_cast<PyObject*>(elems)...);
+tmpref<object> pack(Ts&&... elems) {
+    if (!pyutils::all_nonnull(elems...)) {
+        pyutils::failed_null_check();
+        return nullptr;
+    }
+
+    PyObject *out = PyTuple_New(sizeof...(Ts));
+    if (!out) {
+        return nullptr;
+    }
+    detail::_fill_items(reinterpret_cast<PyTupleObject*>(out)->ob_item,
+                        std::index_sequence_for<Ts...>{},
+                        std::forward<Ts>(elems)...);
+    return out;
 }
@@ -1,21 +1,42 @@
 #pragma once
 #include <array>
 #include <cstdint>
+#include <exception>
+#include <new>
 #include <tuple>
+#include <type_traits>
 
 #include <Python.h>
 
+#include "libpy/convert.h"
 #include "libpy/object.h"
+#include "libpy/policy.h"
 #include "libpy/utils.h"
 
 namespace pyutils {
 /**
-   The format character for the given type. The default case is left
-   unitialized to generate a compile-time error if you attempt to use
-   auto method on a type that has no format character.
+   The format character for the given type. Types without a format
+   character are parsed with an `O&` converter which uses
+   `py::from_python`; this is a compile-time error if there is no
+   conversion for the type.
+
+   Integers are parsed this way too rather than with the `PyArg` integer
+   codes so that small `int`s are read directly from their digits by
+   `py::unbox`.
 */
 template<typename T>
-struct typeformat {};
+struct typeformat {
+    static char_sequence<'O', '&'> cs;
+
+    static int convert(PyObject *ob, void *out) {
+        return !py::from_python<T>::f(ob, *static_cast<T*>(out));
+    }
+
+    template<typename U>
+    static inline auto make_arg(U &&u) {
+        return std::make_tuple(convert, std::forward<U>(u));
+    }
+};
 
 struct _default_make_arg {
     template<typename T>
@@ -39,51 +60,6 @@ struct typeformat<char> : public _default_make_arg {
     static char_sequence<'c'> cs;
 };
 
-template<>
-struct typeformat<unsigned char> : public _default_make_arg {
-    static char_sequence<'b'> cs;
-};
-
-template<>
-struct typeformat<short> : public _default_make_arg {
-    static char_sequence<'h'> cs;
-};
-
-template<>
-struct typeformat<unsigned short> : public _default_make_arg {
-    static char_sequence<'H'> cs;
-};
-
-template<>
-struct typeformat<int> : public _default_make_arg {
-    static char_sequence<'i'> cs;
-};
-
-template<>
-struct typeformat<unsigned int> : public _default_make_arg {
-    static char_sequence<'I'> cs;
-};
-
-template<>
-struct typeformat<long> : public _default_make_arg {
-    static char_sequence<'l'> cs;
-};
-
-template<>
-struct typeformat<unsigned long> : public _default_make_arg {
-    static char_sequence<'k'> cs;
-};
-
-template<>
-struct typeformat<long long> : public _default_make_arg {
-    static char_sequence<'L'> cs;
-};
-
-template<>
-struct typeformat<unsigned long long> : public _default_make_arg {
-    static char_sequence<'K'> cs;
-};
-
 template<>
 struct typeformat<float> : public _default_make_arg {
     static char_sequence<'f'> cs;
@@ -149,6 +125,36 @@ private:
     }
 };
 
+/**
+   Call the function being wrapped and convert its result into a new
+   reference.
+
+   Functions which return `PyObject*` are passed through unchanged. `void`
+   functions return `None`. Other return types are converted with
+   `py::to_python`. If the function raised a Python exception, its result
+   is discarded and `nullptr` is returned.
+*/
+template<typename R, typename F, typename T>
+inline PyObject *_call_automethod(const F &impl, T &&args) {
+    if constexpr (std::is_same<R, PyObject*>::value) {
+        return pyutils::apply(impl, std::forward<T>(args));
+    }
+    else if constexpr (std::is_void<R>::value) {
+        pyutils::apply(impl, std::forward<T>(args));
+        if (PyErr_Occurred()) {
+            return nullptr;
+        }
+        Py_RETURN_NONE;
+    }
+    else {
+        auto result = pyutils::apply(impl, std::forward<T>(args));
+        if (PyErr_Occurred()) {
+            return nullptr;
+        }
+        return py::to_python<decltype(result)>::f(result);
+    }
+}
+
 /**
    Struct which provides a single function `f` which is the actual
    implementation of `_automethod_wrapper` to use. This is implemented
@@ -161,12 +167,17 @@ struct _automethodwrapper_impl {
         using f = _function_traits<F>;
         typename f::parsed_args_type parsed_args;
 
-        if (!apply(PyArg_ParseTuple,
-                   std::tuple_cat(std::make_tuple(args, f::fmtstr().data()),
-                                  f::make_args(tuple_refs(parsed_args))))) {
+        if (!pyutils::apply(
+                PyArg_ParseTuple,
+                std::tuple_cat(std::make_tuple(args, f::fmtstr().data()),
+                               f::make_args(tuple_refs(parsed_args))))) {
             return nullptr;
         }
-        return apply(impl, std::tuple_cat(std::make_tuple(self), parsed_args));
+        // move the parsed arguments so that move-only argument types,
+        // like `buffer_view`, may be passed by value
+        return _call_automethod<typename f::return_type>(
+            impl,
+            std::tuple_cat(std::make_tuple(self), std::move(parsed_args)));
     }
 };
 
@@ -176,8 +187,10 @@ struct _automethodwrapper_impl {
 */
 template<typename F, const F &impl>
 struct _automethodwrapper_impl<0, F, impl> {
-    static inline PyObject *f(PyObject *self, PyObject *args) {
-        return impl(self);
+    static inline PyObject *f(PyObject *self, PyObject*) {
+        return _call_automethod<typename _function_traits<F>::return_type>(
+            impl,
+            std::make_tuple(self));
     }
 };
 
@@ -186,15 +199,42 @@ struct _automethodwrapper_impl<0, F, impl> {
    created PyMethodDef. This has the signature expected for a python
    function and will handle unpacking the arguments.
 
+   C++ exceptions may not unwind through the interpreter so they are
+   translated here: a `py::error_already_set` raises its Python exception
+   again, `std::bad_alloc` raises a `MemoryError`, and other
+   `std::exception`s raise a `RuntimeError` with their `what()` unless a
+   Python exception was already raised, like with `py::err::raise(exc)`.
+
    @param self The module or instance this is a method of.
    @param args The arguments to the method as a `PyTupleObject*`.
    @return     The result of calling our method.
 */
 template<typename F, const F &impl>
 PyObject *_automethodwrapper(PyObject *self, PyObject *args) {
-    return _automethodwrapper_impl<_function_traits<F>::arity,
-                                   F,
-                                   impl>::f(self, args);
+    try {
+        return _automethodwrapper_impl<_function_traits<F>::arity,
+                                       F,
+                                       impl>::f(self, args);
+    }
+    catch (py::error_already_set &e) {
+        e.restore();
+    }
+    catch (const std::bad_alloc&) {
+        PyErr_NoMemory();
+    }
+    catch (const std::exception &e) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_RuntimeError, e.what());
+        }
+    }
+    catch (...) {
+        // exceptions must not unwind through the interpreter
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "unknown C++ exception was thrown");
+        }
+    }
+    return nullptr;
 }
 
 #define _libpy_automethod_def(name, f, doc)  (PyMethodDef {             \
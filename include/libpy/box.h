@@ -0,0 +1,483 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "libpy/object.h"
+
+namespace py {
+/* The conversion traits are defined in `libpy/convert.h`; they are declared
+   here so that the sequence headers may use them in templates.
+*/
+template<typename T, typename = void>
+struct to_python;
+
+template<typename T, typename = void>
+struct from_python;
+
+/**
+   Check if values of type `T` can be boxed with `py::box`.
+*/
+template<typename T>
+struct is_boxable : std::integral_constant<
+    bool,
+    std::is_arithmetic<T>::value || std::is_base_of<py::object, T>::value> {};
+
+/**
+   Box a single C++ value into a new Python object.
+
+   Integers become `int`, floating point values become `float`, and `bool`
+   becomes `True` or `False`. `py::object`s are returned with a new
+   reference. Integers in the small int cache, `[-5, 256]`, reuse the cached
+   objects instead of allocating. Integers wider than a `long long`, like
+   `__int128`, are converted losslessly.
+
+   @param value The value to box.
+   @return      A new reference or `nullptr` with a Python exception raised.
+*/
+template<typename T>
+inline PyObject *box(const T &value) {
+    static_assert(is_boxable<T>::value, "cannot box values of this type");
+
+    if constexpr (std::is_base_of<py::object, T>::value) {
+        if (!value.is_nonnull()) {
+            pyutils::failed_null_check();
+            return nullptr;
+        }
+        return value.incref();
+    }
+    else if constexpr (std::is_same<T, bool>::value) {
+        PyObject *out = value ? Py_True : Py_False;
+        Py_INCREF(out);
+        return out;
+    }
+    else if constexpr (std::is_floating_point<T>::value) {
+        return PyFloat_FromDouble(value);
+    }
+    else if constexpr (sizeof(T) > sizeof(long long)) {
+        // 128 bit integers only need the byte array path when they do not
+        // fit in a machine word
+        if constexpr (std::is_unsigned<T>::value) {
+            if (value <= std::numeric_limits<unsigned long long>::max()) {
+                return PyLong_FromUnsignedLongLong(value);
+            }
+        }
+        else if (value >= std::numeric_limits<long long>::min() &&
+                 value <= std::numeric_limits<long long>::max()) {
+            return PyLong_FromLongLong(value);
+        }
+        return _PyLong_FromByteArray(
+            reinterpret_cast<const unsigned char*>(&value),
+            sizeof(T),
+            PY_LITTLE_ENDIAN,
+            std::is_signed<T>::value);
+    }
+    else if constexpr (std::is_unsigned<T>::value) {
+        if (sizeof(T) <= sizeof(unsigned long)) {
+            return PyLong_FromUnsignedLong(value);
+        }
+        return PyLong_FromUnsignedLongLong(value);
+    }
+    else {
+        if (sizeof(T) <= sizeof(long)) {
+            return PyLong_FromLong(value);
+        }
+        return PyLong_FromLongLong(value);
+    }
+}
+
+namespace detail {
+/**
+   Check if two values would box to the same object.
+
+   Floating point values are compared by their bits so that `-0.0` is not
+   boxed as `0.0`; NaNs with the same payload compare equal.
+*/
+template<typename T>
+inline bool _same_box(const T &a, const T &b) {
+    if constexpr (std::is_base_of<py::object, T>::value) {
+        return a.is_nonnull() && a.is(b);
+    }
+    else if constexpr (std::is_floating_point<T>::value) {
+        return !std::memcmp(&a, &b, sizeof(T));
+    }
+    else {
+        return a == b;
+    }
+}
+}
+
+/**
+   Box a contiguous range of C++ values into an array of new references.
+
+   Runs of repeated values share a single boxed object so, for example, a
+   column of `0.0`s only allocates one `float`.
+
+   On failure, the references written so far are released, `out` is left
+   filled with `nullptr` up to the failing element, and a single Python
+   exception is raised.
+
+   @param out  The storage to write the new references into.
+   @param data The values to box.
+   @param len  The number of values in `data`.
+   @return     zero on success, non-zero on failure.
+*/
+template<typename T>
+int box_range(PyObject **out, const T *data, py::ssize_t len) {
+    PyObject *last = nullptr;
+
+    for (py::ssize_t ix = 0; ix < len; ++ix) {
+        if (last && detail::_same_box(data[ix], data[ix - 1])) {
+            Py_INCREF(last);
+            out[ix] = last;
+            continue;
+        }
+        if (!(last = py::box(data[ix]))) {
+            for (py::ssize_t jx = 0; jx < ix; ++jx) {
+                Py_CLEAR(out[jx]);
+            }
+            return -1;
+        }
+        out[ix] = last;
+    }
+    return 0;
+}
+
+/**
+   Read the value of an `int` directly from its digits without calling
+   into the C API.
+
+   Only values with at most two digits, 60 bits with the usual 30 bit
+   digits, are read; almost every `int` seen in practice is this small.
+   The layout of `int` changed in Python 3.12 so the digit count and sign
+   are read from `lv_tag` there and from `ob_size` before.
+
+   @param ob  An instance of `int`, including subclasses.
+   @param out The value to write.
+   @return    true if the value was read, false if `ob` has more digits and
+              must be converted with the C API. No exception is raised.
+*/
+inline bool read_small_int(PyObject *ob, long long &out) {
+    static_assert(2 * PyLong_SHIFT < std::numeric_limits<long long>::digits,
+                  "two digits must fit in a long long");
+
+    PyLongObject *l = reinterpret_cast<PyLongObject*>(ob);
+#if PY_VERSION_HEX >= 0x030C0000
+    // the low two bits of `lv_tag` are the sign: 0 positive, 1 zero,
+    // 2 negative; the bits above the third are the number of digits
+    std::uintptr_t tag = l->long_value.lv_tag;
+    std::uintptr_t ndigits = tag >> 3;
+    const digit *digits = l->long_value.ob_digit;
+    bool negative = (tag & 3) == 2;
+#else
+    py::ssize_t size = Py_SIZE(ob);
+    py::ssize_t ndigits = size < 0 ? -size : size;
+    const digit *digits = l->ob_digit;
+    bool negative = size < 0;
+#endif
+    long long value;
+    switch (ndigits) {
+    case 0:
+        out = 0;
+        return true;
+    case 1:
+        value = digits[0];
+        break;
+    case 2:
+        value = digits[0] | static_cast<long long>(digits[1]) << PyLong_SHIFT;
+        break;
+    default:
+        return false;
+    }
+    out = negative ? -value : value;
+    return true;
+}
+
+template<typename T>
+int unbox(PyObject *ob, T &out);
+
+namespace detail {
+/**
+   Write the two's complement representation of an `int` into `len` bytes.
+   `_PyLong_AsByteArray` gained a `with_exceptions` argument in 3.13.
+
+   @return zero on success, non-zero with an `OverflowError` raised if the
+           value does not fit.
+*/
+inline int _long_as_byte_array(PyObject *ob,
+                               unsigned char *out,
+                               std::size_t len,
+                               bool little_endian,
+                               bool is_signed) {
+    PyLongObject *l = reinterpret_cast<PyLongObject*>(ob);
+#if PY_VERSION_HEX >= 0x030D0000
+    return _PyLong_AsByteArray(l, out, len, little_endian, is_signed, 1);
+#else
+    return _PyLong_AsByteArray(l, out, len, little_endian, is_signed);
+#endif
+}
+
+/**
+   Unbox an exact `int` into an integer wider than a `long long`.
+*/
+template<typename T>
+int _unbox_wide(PyObject *ob, T &out) {
+    long long value;
+    if (read_small_int(ob, value) && (std::is_signed<T>::value || value >= 0)) {
+        out = static_cast<T>(value);
+        return 0;
+    }
+    T wide;
+    if (_long_as_byte_array(ob,
+                            reinterpret_cast<unsigned char*>(&wide),
+                            sizeof(T),
+                            PY_LITTLE_ENDIAN,
+                            std::is_signed<T>::value)) {
+        return -1;
+    }
+    out = wide;
+    return 0;
+}
+
+/**
+   Unbox an instance of `int`, including subclasses, into an integral `T`
+   without calling back into Python.
+*/
+template<typename T>
+int _unbox_int(PyObject *ob, T &out) {
+    if constexpr (sizeof(T) > sizeof(long long)) {
+        return _unbox_wide(ob, out);
+    }
+
+    int flag = 0;
+    long long value;
+    if (!read_small_int(ob, value)) {
+        value = PyLong_AsLongLongAndOverflow(ob, &flag);
+        if (value == -1 && !flag && PyErr_Occurred()) {
+            return -1;
+        }
+    }
+
+    bool overflow;
+    if constexpr (std::is_signed<T>::value) {
+        overflow = flag ||
+            value < std::numeric_limits<T>::min() ||
+            value > std::numeric_limits<T>::max();
+        out = static_cast<T>(value);
+    }
+    else if (flag > 0) {
+        // too large for a `long long` but may fit as unsigned
+        unsigned long long uvalue = PyLong_AsUnsignedLongLong(ob);
+        if (uvalue == static_cast<unsigned long long>(-1) &&
+            PyErr_Occurred()) {
+            if (!PyErr_ExceptionMatches(PyExc_OverflowError)) {
+                return -1;
+            }
+            PyErr_Clear();
+            overflow = true;
+        }
+        else {
+            overflow = uvalue > std::numeric_limits<T>::max();
+            out = static_cast<T>(uvalue);
+        }
+    }
+    else {
+        overflow = flag || value < 0 ||
+            static_cast<unsigned long long>(value) >
+            std::numeric_limits<T>::max();
+        out = static_cast<T>(value);
+    }
+    if (overflow) {
+        PyErr_Format(PyExc_OverflowError,
+                     "%R does not fit in a %zu byte %s integer",
+                     ob,
+                     sizeof(T),
+                     std::is_signed<T>::value ? "signed" : "unsigned");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+   Narrow a `double` into a floating point `T`. Finite values which are too
+   large for `T` raise an `OverflowError` instead of becoming infinite.
+*/
+template<typename T>
+int _narrow_double(double value, T &out) {
+    out = static_cast<T>(value);
+    if constexpr (sizeof(T) < sizeof(double)) {
+        if (std::isinf(out) && !std::isinf(value)) {
+            PyErr_SetString(PyExc_OverflowError,
+                            "float too large to convert to a C float");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+   Convert an `int` into a floating point `T` with a single rounding.
+
+   `PyLong_AsDouble` rounds correctly to a `double`, but rounding that
+   result again into a narrower `T` may round twice in the same direction.
+   When the `int` has more bits than a `double` holds, the `double` is
+   instead rounded to odd, which a second rounding to a type with at least
+   two fewer bits turns into the correctly rounded result.
+*/
+template<typename T>
+int _long_as_floating(PyObject *ob, T &out) {
+    double value = PyLong_AsDouble(ob);
+    if (value == -1.0 && PyErr_Occurred()) {
+        return -1;
+    }
+    if constexpr (sizeof(T) < sizeof(double)) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if (!(bits & 1) &&
+            _PyLong_NumBits(ob) >
+            static_cast<std::size_t>(std::numeric_limits<double>::digits)) {
+            PyObject *rounded = PyLong_FromDouble(value);
+            if (!rounded) {
+                return -1;
+            }
+            int above = PyObject_RichCompareBool(ob, rounded, Py_GT);
+            int below = above ? 0 :
+                PyObject_RichCompareBool(ob, rounded, Py_LT);
+            Py_DECREF(rounded);
+            if (above < 0 || below < 0) {
+                return -1;
+            }
+            if (above || below) {
+                value = std::nextafter(
+                    value,
+                    above ? std::numeric_limits<double>::infinity() :
+                            -std::numeric_limits<double>::infinity());
+            }
+        }
+    }
+    out = static_cast<T>(value);
+    if (std::isinf(out)) {
+        PyErr_SetString(PyExc_OverflowError,
+                        "int too large to convert to float");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+   Unbox an object which is not an exact `int`, `float`, or `bool` by
+   going through `__index__` or `__float__`.
+
+   `ob` is kept alive across the call in case user code drops the last
+   reference to it, for example by mutating the list it came from.
+*/
+template<typename T>
+int _unbox_slow(PyObject *ob, T &out) {
+    Py_INCREF(ob);
+    int status;
+    if constexpr (std::is_floating_point<T>::value) {
+        double value = PyFloat_AsDouble(ob);
+        status = (value == -1.0 && PyErr_Occurred()) ?
+            -1 :
+            _narrow_double(value, out);
+    }
+    else {
+        // before 3.10 `__index__` may return an `int` subclass, like a
+        // `bool` or an `IntEnum`, which must not come back through here
+        PyObject *as_int = PyNumber_Index(ob);
+        status = as_int ? _unbox_int(as_int, out) : -1;
+        Py_XDECREF(as_int);
+    }
+    Py_DECREF(ob);
+    return status;
+}
+}
+
+/**
+   Unbox a single Python object into a C++ value.
+
+   Exact `int` and `float` objects are read directly without going through
+   the number protocol, and small `int`s are read from their digits with
+   `read_small_int`. Other objects are converted with `__index__` for
+   integral `T` or `__float__` for floating point `T`.
+
+   Conversions are exact:
+
+   - `int`s which do not fit in an integral `T` raise an `OverflowError`.
+   - `float`s are never truncated into an integral `T`; they raise a
+     `TypeError` like `operator.index`.
+   - `int`s are converted to floating point `T` with a single correct
+     rounding, and `int`s too large for `T` raise an `OverflowError`.
+   - finite `float`s too large for a `float` `T` raise an `OverflowError`
+     instead of becoming infinite.
+   - `bool` only accepts `True` and `False`.
+
+   @param ob  The object to unbox.
+   @param out The value to write.
+   @return    zero on success, non-zero on failure.
+*/
+template<typename T>
+int unbox(PyObject *ob, T &out) {
+    static_assert(std::is_arithmetic<T>::value,
+                  "can only unbox into arithmetic types");
+
+    if (!ob) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+
+    if constexpr (std::is_same<T, bool>::value) {
+        if (ob == Py_True || ob == Py_False) {
+            out = ob == Py_True;
+            return 0;
+        }
+        PyErr_Format(PyExc_TypeError,
+                     "expected a bool, got %.200s",
+                     Py_TYPE(ob)->tp_name);
+        return -1;
+    }
+    else if constexpr (std::is_floating_point<T>::value) {
+        if (PyFloat_CheckExact(ob)) {
+            return detail::_narrow_double(PyFloat_AS_DOUBLE(ob), out);
+        }
+        if (PyLong_CheckExact(ob)) {
+            long long small;
+            if (read_small_int(ob, small)) {
+                out = static_cast<T>(small);
+                return 0;
+            }
+            return detail::_long_as_floating(ob, out);
+        }
+        return detail::_unbox_slow(ob, out);
+    }
+    else {
+        if (!PyLong_CheckExact(ob)) {
+            return detail::_unbox_slow(ob, out);
+        }
+        return detail::_unbox_int(ob, out);
+    }
+}
+
+/**
+   Unbox an array of Python objects into a contiguous C++ array.
+
+   @param out   The storage to write the values into.
+   @param items The objects to unbox.
+   @param len   The number of objects in `items`.
+   @return      zero on success, non-zero on failure. On failure a Python
+                exception is raised and the contents of `out` are
+                unspecified.
+*/
+template<typename T>
+int unbox_range(T *out, PyObject *const *items, py::ssize_t len) {
+    for (py::ssize_t ix = 0; ix < len; ++ix) {
+        if (py::unbox(items[ix], out[ix])) {
+            return -1;
+        }
+    }
+    return 0;
+}
+}
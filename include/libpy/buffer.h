@@ -0,0 +1,293 @@
+#pragma once
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "libpy/object.h"
+
+namespace py {
+/**
+   The category of a single buffer format character.
+*/
+enum class buffer_kind : char {
+    signed_int = 'i',
+    unsigned_int = 'u',
+    floating = 'f',
+    boolean = 'b',
+    character = 'c',
+};
+
+namespace detail {
+/**
+   The buffer kind for an element type.
+*/
+template<typename T>
+struct _buffer_kind {
+    static_assert(std::is_arithmetic<T>::value,
+                  "buffer elements must be arithmetic types");
+
+    static constexpr buffer_kind value =
+        std::is_same<T, bool>::value ? buffer_kind::boolean :
+        std::is_same<T, char>::value ? buffer_kind::character :
+        std::is_floating_point<T>::value ? buffer_kind::floating :
+        std::is_signed<T>::value ? buffer_kind::signed_int :
+        buffer_kind::unsigned_int;
+};
+}
+
+/**
+   Check that an acquired buffer holds elements of a given kind and size.
+
+   Formats are compared by kind and item size rather than by character so
+   that, for example, a numpy `int64` array (format `'l'`) may be viewed as
+   `long long`. Byte order prefixes are accepted when they agree with the
+   native byte order.
+
+   @param buf      The buffer to check.
+   @param kind     The expected kind of element.
+   @param itemsize The expected size of each element.
+   @param ndim     The expected number of dimensions.
+   @return         zero if the buffer matches, otherwise non-zero and a
+                   Python exception is raised.
+*/
+int buffer_check(const Py_buffer &buf,
+                 buffer_kind kind,
+                 py::ssize_t itemsize,
+                 int ndim);
+
+/**
+   An owning, typed view over the memory of an object which exports the
+   buffer protocol, for example a `bytearray`, `memoryview`, or numpy array.
+
+   The format, item size, and number of dimensions are validated against
+   `T` and `ndim` when the buffer is acquired so element access does not need
+   any further checks. The buffer is released when the view is destroyed.
+
+   If `T` is `const` the buffer may be read only, otherwise a writable buffer
+   is requested.
+
+   Like `py::object`, `is_nonnull()` reports if the view is valid.
+*/
+template<typename T, int ndim = 1>
+class buffer_view {
+private:
+    static_assert(ndim >= 1, "buffer_view must have at least 1 dimension");
+
+    Py_buffer buf;
+    bool acquired;
+
+    using element_type = std::remove_const_t<T>;
+
+    template<std::size_t... ixs, typename... Ixs>
+    inline py::ssize_t offset(std::index_sequence<ixs...>,
+                              Ixs... ixs_) const {
+        return ((static_cast<py::ssize_t>(ixs_) * buf.strides[ixs]) + ... + 0);
+    }
+
+    /**
+       Steal the buffer from another view.
+
+       Exporters which use `PyBuffer_FillInfo`, like `bytes` and `bytearray`,
+       point `shape` and `strides` into the `Py_buffer` itself, so those
+       pointers are redirected at our copy.
+    */
+    void take(buffer_view &mvfrom) noexcept {
+        buf = mvfrom.buf;
+        if (mvfrom.buf.shape == &mvfrom.buf.len) {
+            buf.shape = &buf.len;
+        }
+        if (mvfrom.buf.strides == &mvfrom.buf.itemsize) {
+            buf.strides = &buf.itemsize;
+        }
+        acquired = mvfrom.acquired;
+        mvfrom.acquired = false;
+    }
+
+public:
+    typedef T value_type;
+
+    /**
+       The flags passed to `PyObject_GetBuffer`.
+    */
+    static constexpr int flags = std::is_const<T>::value ?
+        PyBUF_RECORDS_RO :
+        PyBUF_RECORDS;
+
+    /**
+       Default constructor. The view will not hold a buffer.
+    */
+    buffer_view() : acquired(false) {}
+
+    /**
+       Acquire a buffer from `ob`. If `ob` does not export a buffer that
+       matches `T` and `ndim`, the view will not hold a buffer and a Python
+       exception will be raised.
+
+       @param ob The object to view.
+    */
+    explicit buffer_view(const py::object &ob) : acquired(false) {
+        if (!ob.is_nonnull()) {
+            pyutils::failed_null_check();
+            return;
+        }
+        if (PyObject_GetBuffer(ob, &buf, flags)) {
+            return;
+        }
+        acquired = true;
+        if (buffer_check(buf,
+                         detail::_buffer_kind<element_type>::value,
+                         sizeof(T),
+                         ndim)) {
+            release();
+        }
+    }
+
+    buffer_view(const buffer_view&) = delete;
+    buffer_view &operator=(const buffer_view&) = delete;
+
+    buffer_view(buffer_view &&mvfrom) noexcept : acquired(false) {
+        take(mvfrom);
+    }
+
+    buffer_view &operator=(buffer_view &&mvfrom) noexcept {
+        if (this != &mvfrom) {
+            release();
+            take(mvfrom);
+        }
+        return *this;
+    }
+
+    ~buffer_view() {
+        release();
+    }
+
+    /**
+       Release the buffer early. The view will no longer hold a buffer.
+    */
+    void release() {
+        if (acquired) {
+            PyBuffer_Release(&buf);
+            acquired = false;
+        }
+    }
+
+    /**
+       Check if the view holds a buffer.
+
+       @return true if the view holds a buffer.
+    */
+    inline bool is_nonnull() const {
+        return acquired;
+    }
+
+    /**
+       The object that exported the buffer.
+    */
+    inline py::object owner() const {
+        return acquired ? buf.obj : nullptr;
+    }
+
+    /**
+       The underlying `Py_buffer`.
+    */
+    inline const Py_buffer &raw() const {
+        return buf;
+    }
+
+    /**
+       Get the number of elements along a dimension.
+
+       @param dim The dimension to look up.
+       @return    The number of elements along `dim`.
+    */
+    inline py::ssize_t shape(int dim = 0) const {
+        return buf.shape[dim];
+    }
+
+    /**
+       Get the number of bytes between elements along a dimension.
+
+       @param dim The dimension to look up.
+       @return    The stride along `dim` in bytes.
+    */
+    inline py::ssize_t stride(int dim = 0) const {
+        return buf.strides[dim];
+    }
+
+    /**
+       Get the total number of elements in the buffer.
+    */
+    inline py::ssize_t size() const {
+        return buf.len / static_cast<py::ssize_t>(sizeof(T));
+    }
+
+    /**
+       Check if the elements are laid out contiguously in C order. When this
+       is true, `data()` may be indexed directly for `size()` elements.
+    */
+    inline bool is_contiguous() const {
+        return PyBuffer_IsContiguous(&buf, 'C');
+    }
+
+    /**
+       A pointer to the first element in the buffer.
+    */
+    inline T *data() const {
+        return static_cast<T*>(buf.buf);
+    }
+
+    /**
+       Look up an element of a 1 dimensional buffer, following the stride.
+
+       @param ix The index of the element.
+       @return   A reference to the element.
+    */
+    inline T &operator[](py::ssize_t ix) const {
+        static_assert(ndim == 1, "operator[] requires a 1d buffer_view");
+        return *reinterpret_cast<T*>(static_cast<char*>(buf.buf) +
+                                     ix * buf.strides[0]);
+    }
+
+    /**
+       Look up an element of the buffer by one index per dimension,
+       following the strides.
+
+       @param ixs The index along each dimension.
+       @return    A reference to the element.
+    */
+    template<typename... Ixs>
+    inline T &operator()(Ixs... ixs) const {
+        static_assert(sizeof...(Ixs) == ndim,
+                      "operator() requires one index per dimension");
+        return *reinterpret_cast<T*>(
+            static_cast<char*>(buf.buf) +
+            offset(std::make_index_sequence<ndim>{}, ixs...));
+    }
+};
+}
+
+namespace pyutils {
+template<typename T>
+struct typeformat;
+
+/**
+   `buffer_view` arguments are parsed with an `O&` converter which acquires
+   and validates the buffer. The buffer is released when the parsed
+   arguments go out of scope.
+*/
+template<typename T, int ndim>
+struct typeformat<py::buffer_view<T, ndim>> {
+    static char_sequence<'O', '&'> cs;
+
+    static int convert(PyObject *ob, void *out) {
+        auto &view = *static_cast<py::buffer_view<T, ndim>*>(out);
+        view = py::buffer_view<T, ndim>(ob);
+        return view.is_nonnull();
+    }
+
+    template<typename U>
+    static inline auto make_arg(U &&u) {
+        return std::make_tuple(convert, std::forward<U>(u));
+    }
+};
+}
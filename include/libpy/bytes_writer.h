@@ -0,0 +1,190 @@
+#pragma once
+#include <cstring>
+#include <string_view>
+
+#include "libpy/object.h"
+
+namespace py {
+/**
+   Build a `bytes` object in place.
+
+   Data is written directly into the storage of a `bytes` object which is
+   grown geometrically with `_PyBytes_Resize`. `finalize()` trims the
+   allocation to the number of bytes written and hands back the object
+   without a copy.
+
+   When an allocation fails the writer enters a failed state: every further
+   write returns non-zero and `finalize()` returns `nullptr`. Like
+   `py::object`, `is_nonnull()` reports if the writer is usable.
+*/
+class bytes_writer {
+private:
+    /**
+       The `bytes` object being built. This is `nullptr` until the first
+       allocation and after a failed allocation.
+    */
+    PyObject *ob;
+    py::ssize_t len;
+    py::ssize_t cap;
+    bool failed;
+
+    /**
+       Grow the buffer to hold at least `needed` bytes.
+
+       @param needed The minimum capacity.
+       @return       zero on success, non-zero if an exception occured.
+    */
+    int grow(py::ssize_t needed);
+
+public:
+    /**
+       Create a writer.
+
+       @param capacity The number of bytes to preallocate.
+    */
+    explicit bytes_writer(py::ssize_t capacity = 0);
+
+    bytes_writer(const bytes_writer&) = delete;
+    bytes_writer &operator=(const bytes_writer&) = delete;
+
+    bytes_writer(bytes_writer &&mvfrom) noexcept;
+    bytes_writer &operator=(bytes_writer &&mvfrom) noexcept;
+
+    ~bytes_writer();
+
+    /**
+       Check if the writer is usable.
+
+       @return false if an allocation has failed.
+    */
+    inline bool is_nonnull() const {
+        return !failed;
+    }
+
+    /**
+       The number of bytes written so far.
+    */
+    inline py::ssize_t size() const {
+        return len;
+    }
+
+    /**
+       The number of bytes that may be written without reallocating.
+    */
+    inline py::ssize_t capacity() const {
+        return cap;
+    }
+
+    /**
+       A pointer to the bytes written so far. This is invalidated by any
+       write that grows the buffer.
+    */
+    inline char *data() const {
+        return ob ? PyBytes_AS_STRING(ob) : nullptr;
+    }
+
+    /**
+       Make sure that at least `n` more bytes can be written without
+       reallocating.
+
+       @param n The number of bytes to reserve.
+       @return  zero on success, non-zero if an exception occured.
+    */
+    inline int reserve(py::ssize_t n) {
+        if (failed) {
+            pyutils::failed_null_check();
+            return -1;
+        }
+        if (cap - len < n) {
+            // `len + n` may overflow; anything that large is too big for a
+            // `bytes` object and `grow` reports it as a `MemoryError`
+            return grow(n > PY_SSIZE_T_MAX - len ? PY_SSIZE_T_MAX : len + n);
+        }
+        return 0;
+    }
+
+    /**
+       Get space to write `n` bytes into directly. After filling in up to
+       `n` bytes, call `commit` with the number of bytes actually written.
+
+       @param n The number of bytes to make space for.
+       @return  A pointer to the end of the written data or `nullptr` if an
+                exception occured.
+    */
+    inline char *prepare(py::ssize_t n) {
+        if (reserve(n)) {
+            return nullptr;
+        }
+        if (!ob) {
+            // only a fresh writer asked for zero bytes gets here; there is
+            // no storage yet but the result must not look like a failure
+            static char empty;
+            return &empty;
+        }
+        return PyBytes_AS_STRING(ob) + len;
+    }
+
+    /**
+       Mark bytes written into the space returned by `prepare` as part of
+       the output.
+
+       @param n The number of bytes written.
+    */
+    inline void commit(py::ssize_t n) {
+        len += n;
+    }
+
+    /**
+       Append bytes to the output.
+
+       @param data The data to append.
+       @param n    The number of bytes to append.
+       @return     zero on success, non-zero if an exception occured.
+    */
+    inline int write(const void *data, py::ssize_t n) {
+        char *out = prepare(n);
+        if (!out) {
+            return -1;
+        }
+        if (n) {
+            std::memcpy(out, data, n);
+        }
+        len += n;
+        return 0;
+    }
+
+    /**
+       Append bytes to the output.
+
+       @param data The data to append.
+       @return     zero on success, non-zero if an exception occured.
+    */
+    inline int write(std::string_view data) {
+        return write(data.data(), data.size());
+    }
+
+    /**
+       Append a single byte to the output.
+
+       @param c The byte to append.
+       @return  zero on success, non-zero if an exception occured.
+    */
+    inline int put(char c) {
+        char *out = prepare(1);
+        if (!out) {
+            return -1;
+        }
+        *out = c;
+        ++len;
+        return 0;
+    }
+
+    /**
+       Trim the allocation to the bytes written and take the result. The
+       writer is reset to an empty state.
+
+       @return The `bytes` object or `nullptr` if an exception occured.
+    */
+    tmpref<py::object> finalize();
+};
+}
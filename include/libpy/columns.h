@@ -0,0 +1,203 @@
+#pragma once
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "libpy/convert.h"
+#include "libpy/list.h"
+#include "libpy/object.h"
+
+namespace py {
+/**
+   Struct-of-arrays storage for rows of Python tuples.
+
+   Each column is a `std::vector` of one of `Ts`. Cells are converted with
+   `py::from_python` and `py::to_python`, so the conversion for each column
+   is picked at compile time rather than per cell.
+
+   The columns are reused by `from_rows` so one `columns` may be used to
+   read many batches without reallocating.
+*/
+template<typename... Ts>
+class columns {
+private:
+    static_assert(sizeof...(Ts) > 0, "columns requires at least one column");
+
+    using indices = std::index_sequence_for<Ts...>;
+
+    std::tuple<std::vector<Ts>...> cols;
+
+    template<std::size_t... ixs>
+    void resize_impl(std::size_t len, std::index_sequence<ixs...>) {
+        (std::get<ixs>(cols).resize(len), ...);
+    }
+
+    template<std::size_t ix>
+    int read_cell(PyObject *row, std::size_t rowix) {
+        using T = std::tuple_element_t<ix, std::tuple<Ts...>>;
+
+        T value;
+        if (from_python<T>::f(PyTuple_GET_ITEM(row, ix), value)) {
+            return -1;
+        }
+        std::get<ix>(cols)[rowix] = std::move(value);
+        return 0;
+    }
+
+    template<std::size_t... ixs>
+    int read_row(PyObject *row,
+                 std::size_t rowix,
+                 std::index_sequence<ixs...>) {
+        return (read_cell<ixs>(row, rowix) || ...) ? -1 : 0;
+    }
+
+    template<std::size_t... ixs>
+    PyObject *write_row(std::size_t rowix, std::index_sequence<ixs...>) const {
+        PyObject *row = PyTuple_New(sizeof...(Ts));
+        if (!row) {
+            return nullptr;
+        }
+        PyObject **items = reinterpret_cast<PyTupleObject*>(row)->ob_item;
+        bool ok = ((items[ixs] = to_python<Ts>::f(
+                        std::get<ixs>(cols)[rowix])) && ...);
+        if (!ok) {
+            Py_DECREF(row);
+            return nullptr;
+        }
+        return row;
+    }
+
+    template<std::size_t... ixs>
+    bool same_size(std::index_sequence<ixs...>) const {
+        return ((std::get<ixs>(cols).size() == std::get<0>(cols).size()) &&
+                ...);
+    }
+
+public:
+    /**
+       The number of columns.
+    */
+    static constexpr std::size_t width = sizeof...(Ts);
+
+    columns() = default;
+
+    /**
+       Get a column by index.
+    */
+    template<std::size_t ix>
+    inline auto &get() {
+        return std::get<ix>(cols);
+    }
+
+    template<std::size_t ix>
+    inline const auto &get() const {
+        return std::get<ix>(cols);
+    }
+
+    /**
+       The number of rows. This is the length of the first column.
+    */
+    inline std::size_t size() const {
+        return std::get<0>(cols).size();
+    }
+
+    /**
+       Resize every column to `len` rows.
+    */
+    void resize(std::size_t len) {
+        resize_impl(len, indices{});
+    }
+
+    /**
+       Read a `list` or `tuple` of row tuples into the columns.
+
+       Every row must be a `tuple` with one element per column. The
+       columns are resized to the number of rows and overwritten, keeping
+       their capacity.
+
+       @param rows The rows to read.
+       @return zero on success, non-zero on failure. On failure a Python
+               exception is raised and the contents of the columns are
+               unspecified.
+    */
+    int from_rows(const py::object &rows) {
+        if (!rows.is_nonnull()) {
+            pyutils::failed_null_check();
+            return -1;
+        }
+
+        PyObject *seq = rows;
+        if (!(PyList_Check(seq) || PyTuple_Check(seq))) {
+            PyErr_Format(PyExc_TypeError,
+                         "expected a list or tuple of rows, got %.200s",
+                         Py_TYPE(seq)->tp_name);
+            return -1;
+        }
+
+        py::ssize_t len = PySequence_Fast_GET_SIZE(seq);
+        resize(len);
+        for (py::ssize_t ix = 0; ix < len; ++ix) {
+            // converting a cell may run Python code which resizes the list
+            if (ix >= PySequence_Fast_GET_SIZE(seq)) {
+                PyErr_SetString(PyExc_RuntimeError,
+                                "rows changed size during conversion");
+                return -1;
+            }
+            PyObject *row = PySequence_Fast_GET_ITEM(seq, ix);
+            if (!PyTuple_Check(row)) {
+                PyErr_Format(PyExc_TypeError,
+                             "row %zd is not a tuple, got %.200s",
+                             ix,
+                             Py_TYPE(row)->tp_name);
+                return -1;
+            }
+            if (PyTuple_GET_SIZE(row) != static_cast<py::ssize_t>(width)) {
+                PyErr_Format(PyExc_ValueError,
+                             "row %zd has %zd elements, expected %zu",
+                             ix,
+                             PyTuple_GET_SIZE(row),
+                             width);
+                return -1;
+            }
+
+            Py_INCREF(row);
+            int status = read_row(row, ix, indices{});
+            Py_DECREF(row);
+            if (status) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+       Box the columns into a new list of row tuples.
+
+       @return A new list or nullptr. All of the columns must have the same
+               length.
+    */
+    tmpref<list::object> to_rows() const {
+        if (!same_size(indices{})) {
+            PyErr_SetString(PyExc_ValueError,
+                            "columns do not have the same length");
+            return nullptr;
+        }
+
+        std::size_t len = size();
+        tmpref<list::object> out(static_cast<py::ssize_t>(len));
+        if (!out.is_nonnull()) {
+            return nullptr;
+        }
+        PyObject *l = out;
+        for (std::size_t ix = 0; ix < len; ++ix) {
+            PyObject *row = write_row(ix, indices{});
+            if (!row) {
+                return nullptr;
+            }
+            PyList_SET_ITEM(l, ix, row);
+        }
+        return out;
+    }
+};
+}
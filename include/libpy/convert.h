@@ -0,0 +1,513 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "libpy/box.h"
+#include "libpy/list.h"
+#include "libpy/object.h"
+#include "libpy/tuple.h"
+
+namespace py {
+/**
+   Conversion from a C++ value to a new Python object.
+
+   Specializations provide:
+
+   ```
+   static PyObject *f(const T &value);
+   ```
+
+   which returns a new reference, or `nullptr` with a Python exception
+   raised. Container specializations convert their elements with the
+   `to_python` of the element type so conversions compose to any depth.
+
+   | C++                                   | Python              |
+   |---------------------------------------|---------------------|
+   | arithmetic types                      | `int`/`float`/`bool`|
+   | `py::object` and subclasses           | the same object     |
+   | `std::string`                         | `str`               |
+   | `std::vector<T>`, `std::array<T, N>`  | `list`              |
+   | `std::pair<A, B>`, `std::tuple<Ts...>`| `tuple`             |
+   | `std::optional<T>`                    | `None` or `T`       |
+   | `std::map<K, V>`, `std::unordered_map`| `dict`              |
+*/
+template<typename T, typename>
+struct to_python {
+    static_assert(!std::is_same<T, T>::value,
+                  "no to_python conversion for this type");
+};
+
+/**
+   Conversion from a Python object into a C++ value.
+
+   Specializations provide:
+
+   ```
+   static int f(PyObject *ob, T &out);
+   ```
+
+   which returns zero on success, or non-zero with a Python exception
+   raised. `py::object` outputs hold borrowed references to `ob` or its
+   elements. Containers of `py::object`s may therefore only be read from a
+   `list` or `tuple`; the elements of other sequences would not outlive
+   the conversion.
+*/
+template<typename T, typename>
+struct from_python {
+    static_assert(!std::is_same<T, T>::value,
+                  "no from_python conversion for this type");
+};
+
+namespace detail {
+/**
+   Check if a `std::vector` or `std::array` of `T` can be converted with
+   the bulk boxing and unboxing paths.
+*/
+template<typename T>
+constexpr bool _bulk_convertible =
+    std::is_arithmetic<T>::value && !std::is_same<T, bool>::value;
+
+/**
+   Convert each element of a C++ sequence into a new list.
+*/
+template<typename Seq>
+PyObject *_sequence_to_list(const Seq &seq) {
+    using T = typename Seq::value_type;
+
+    if constexpr (_bulk_convertible<T> ||
+                  std::is_base_of<py::object, T>::value) {
+        auto out = py::list::from_range(seq);
+        PyObject *ob = out;
+        std::move(out).invalidate();
+        return ob;
+    }
+    else {
+        PyObject *out = PyList_New(seq.size());
+        if (!out) {
+            return nullptr;
+        }
+        for (std::size_t ix = 0; ix < seq.size(); ++ix) {
+            PyObject *item = to_python<T>::f(seq[ix]);
+            if (!item) {
+                Py_DECREF(out);
+                return nullptr;
+            }
+            PyList_SET_ITEM(out, ix, item);
+        }
+        return out;
+    }
+}
+
+/**
+   Convert each element of a Python sequence into the first `len` elements
+   of a C++ sequence.
+*/
+template<typename Seq>
+int _sequence_from_items(PyObject *const *items, py::ssize_t len, Seq &out) {
+    using T = typename Seq::value_type;
+
+    if constexpr (_bulk_convertible<T>) {
+        return py::unbox_range(out.data(), items, len);
+    }
+    else {
+        for (py::ssize_t ix = 0; ix < len; ++ix) {
+            T value;
+            if (from_python<T>::f(items[ix], value)) {
+                return -1;
+            }
+            out[ix] = std::move(value);
+        }
+        return 0;
+    }
+}
+
+/**
+   Check if converting into a `T` stores borrowed `py::object`s, directly
+   or inside of a container.
+*/
+template<typename T>
+struct _holds_borrowed
+    : std::integral_constant<bool, std::is_base_of<py::object, T>::value> {};
+
+template<typename T, typename A>
+struct _holds_borrowed<std::vector<T, A>> : _holds_borrowed<T> {};
+
+template<typename T, std::size_t N>
+struct _holds_borrowed<std::array<T, N>> : _holds_borrowed<T> {};
+
+template<typename T>
+struct _holds_borrowed<std::optional<T>> : _holds_borrowed<T> {};
+
+template<typename A, typename B>
+struct _holds_borrowed<std::pair<A, B>>
+    : std::integral_constant<bool,
+                             _holds_borrowed<A>::value ||
+                             _holds_borrowed<B>::value> {};
+
+template<typename... Ts>
+struct _holds_borrowed<std::tuple<Ts...>>
+    : std::integral_constant<bool, (_holds_borrowed<Ts>::value || ...)> {};
+
+template<typename K, typename V, typename C, typename A>
+struct _holds_borrowed<std::map<K, V, C, A>>
+    : std::integral_constant<bool,
+                             _holds_borrowed<K>::value ||
+                             _holds_borrowed<V>::value> {};
+
+template<typename K, typename V, typename H, typename E, typename A>
+struct _holds_borrowed<std::unordered_map<K, V, H, E, A>>
+    : std::integral_constant<bool,
+                             _holds_borrowed<K>::value ||
+                             _holds_borrowed<V>::value> {};
+
+/**
+   Get a tuple of the elements of a Python iterable. Tuples are returned
+   with a new reference; lists are copied so that converting an element may
+   not resize the storage being read from.
+
+   The elements of other sequences, like a `range` or a generator, are
+   owned only by the returned tuple. When `T`, the type being converted
+   into, stores borrowed `py::object`s they would dangle once the tuple is
+   released, so only lists and tuples are accepted.
+*/
+template<typename T>
+py::tmpref<py::tuple::object> _as_tuple(PyObject *ob) {
+    if (PyTuple_CheckExact(ob)) {
+        Py_INCREF(ob);
+        return ob;
+    }
+    if (!PySequence_Check(ob) || PyUnicode_Check(ob) || PyBytes_Check(ob)) {
+        PyErr_Format(PyExc_TypeError,
+                     "expected a sequence, got %.200s",
+                     Py_TYPE(ob)->tp_name);
+        return nullptr;
+    }
+    if constexpr (_holds_borrowed<T>::value) {
+        if (!(PyList_Check(ob) || PyTuple_Check(ob))) {
+            PyErr_Format(PyExc_TypeError,
+                         "expected a list or tuple to borrow py::object "
+                         "elements from, got %.200s",
+                         Py_TYPE(ob)->tp_name);
+            return nullptr;
+        }
+    }
+    return PySequence_Tuple(ob);
+}
+
+template<typename Tuple, std::size_t... ixs>
+PyObject *_tuple_to_python(const Tuple &t, std::index_sequence<ixs...>) {
+    PyObject *out = PyTuple_New(sizeof...(ixs));
+    if (!out) {
+        return nullptr;
+    }
+    PyObject **items = reinterpret_cast<PyTupleObject*>(out)->ob_item;
+    bool ok = ((items[ixs] = to_python<std::tuple_element_t<ixs, Tuple>>::f(
+                    std::get<ixs>(t))) && ...);
+    if (!ok) {
+        Py_DECREF(out);
+        return nullptr;
+    }
+    return out;
+}
+
+template<typename Tuple, std::size_t... ixs>
+int _tuple_from_python(PyObject *ob, Tuple &out, std::index_sequence<ixs...>) {
+    auto t = _as_tuple<Tuple>(ob);
+    if (!t.is_nonnull()) {
+        return -1;
+    }
+    if (PyTuple_GET_SIZE(static_cast<PyObject*>(t)) !=
+        static_cast<py::ssize_t>(sizeof...(ixs))) {
+        PyErr_Format(PyExc_ValueError,
+                     "expected a sequence of length %zu, got %zd",
+                     sizeof...(ixs),
+                     PyTuple_GET_SIZE(static_cast<PyObject*>(t)));
+        return -1;
+    }
+    bool ok = (!from_python<std::tuple_element_t<ixs, Tuple>>::f(
+                   PyTuple_GET_ITEM(static_cast<PyObject*>(t), ixs),
+                   std::get<ixs>(out)) && ...);
+    return ok ? 0 : -1;
+}
+
+template<typename Map>
+PyObject *_map_to_python(const Map &map) {
+    using K = typename Map::key_type;
+    using V = typename Map::mapped_type;
+
+    PyObject *out = _PyDict_NewPresized(map.size());
+    if (!out) {
+        return nullptr;
+    }
+    for (const auto &[key, value] : map) {
+        py::tmpref<py::object> k(to_python<K>::f(key));
+        if (!k.is_nonnull()) {
+            Py_DECREF(out);
+            return nullptr;
+        }
+        py::tmpref<py::object> v(to_python<V>::f(value));
+        if (!v.is_nonnull() || PyDict_SetItem(out, k, v)) {
+            Py_DECREF(out);
+            return nullptr;
+        }
+    }
+    return out;
+}
+
+template<typename Map>
+int _map_from_python(PyObject *ob, Map &out) {
+    using K = typename Map::key_type;
+    using V = typename Map::mapped_type;
+
+    if (!PyDict_Check(ob)) {
+        PyErr_Format(PyExc_TypeError,
+                     "expected a dict, got %.200s",
+                     Py_TYPE(ob)->tp_name);
+        return -1;
+    }
+    out.clear();
+
+    py::ssize_t len = reinterpret_cast<PyDictObject*>(ob)->ma_used;
+    py::ssize_t pos = 0;
+    PyObject *key;
+    PyObject *value;
+    while (PyDict_Next(ob, &pos, &key, &value)) {
+        // converting may run Python code which mutates the dict, so hold
+        // our own references to the entry
+        Py_INCREF(key);
+        Py_INCREF(value);
+        K k;
+        V v;
+        int status = from_python<K>::f(key, k) || from_python<V>::f(value, v);
+        Py_DECREF(key);
+        Py_DECREF(value);
+        if (status) {
+            return -1;
+        }
+        if (reinterpret_cast<PyDictObject*>(ob)->ma_used != len) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "dict changed size during conversion");
+            return -1;
+        }
+        out.insert_or_assign(std::move(k), std::move(v));
+    }
+    return 0;
+}
+}
+
+template<typename T>
+struct to_python<T, std::enable_if_t<std::is_arithmetic<T>::value>> {
+    static PyObject *f(const T &value) {
+        return py::box(value);
+    }
+};
+
+template<typename T>
+struct from_python<T, std::enable_if_t<std::is_arithmetic<T>::value>> {
+    static int f(PyObject *ob, T &out) {
+        return py::unbox(ob, out);
+    }
+};
+
+template<typename T>
+struct to_python<T, std::enable_if_t<std::is_base_of<py::object, T>::value>> {
+    static PyObject *f(const T &value) {
+        return py::box(value);
+    }
+};
+
+template<typename T>
+struct from_python<T,
+                   std::enable_if_t<std::is_base_of<py::object, T>::value &&
+                                    !detail::_is_tmpref<T>::value>> {
+    static int f(PyObject *ob, T &out) {
+        // subclasses like `py::list::object` check the type of `ob`
+        T checked(ob);
+        if (!checked.is_nonnull()) {
+            pyutils::failed_null_check();
+            return -1;
+        }
+        static_cast<py::object&>(out) = checked;
+        return 0;
+    }
+};
+
+template<>
+struct to_python<std::string> {
+    static PyObject *f(const std::string &value) {
+        return PyUnicode_FromStringAndSize(value.data(), value.size());
+    }
+};
+
+template<>
+struct from_python<std::string> {
+    static int f(PyObject *ob, std::string &out) {
+        if (!PyUnicode_Check(ob)) {
+            PyErr_Format(PyExc_TypeError,
+                         "expected a str, got %.200s",
+                         Py_TYPE(ob)->tp_name);
+            return -1;
+        }
+        py::ssize_t len;
+        const char *data = PyUnicode_AsUTF8AndSize(ob, &len);
+        if (!data) {
+            return -1;
+        }
+        out.assign(data, len);
+        return 0;
+    }
+};
+
+template<typename T, typename A>
+struct to_python<std::vector<T, A>> {
+    static PyObject *f(const std::vector<T, A> &value) {
+        return detail::_sequence_to_list(value);
+    }
+};
+
+template<typename T, typename A>
+struct from_python<std::vector<T, A>> {
+    static int f(PyObject *ob, std::vector<T, A> &out) {
+        if constexpr (detail::_bulk_convertible<T> &&
+                      std::is_same<A, std::allocator<T>>::value) {
+            if (PyList_CheckExact(ob)) {
+                return py::list::object(ob).to_vector(out);
+            }
+        }
+        auto t = detail::_as_tuple<T>(ob);
+        if (!t.is_nonnull()) {
+            return -1;
+        }
+        py::ssize_t len = PyTuple_GET_SIZE(static_cast<PyObject*>(t));
+        out.resize(len);
+        return detail::_sequence_from_items(
+            reinterpret_cast<PyTupleObject*>(
+                static_cast<PyObject*>(t))->ob_item,
+            len,
+            out);
+    }
+};
+
+template<typename T, std::size_t N>
+struct to_python<std::array<T, N>> {
+    static PyObject *f(const std::array<T, N> &value) {
+        return detail::_sequence_to_list(value);
+    }
+};
+
+template<typename T, std::size_t N>
+struct from_python<std::array<T, N>> {
+    static int f(PyObject *ob, std::array<T, N> &out) {
+        auto t = detail::_as_tuple<T>(ob);
+        if (!t.is_nonnull()) {
+            return -1;
+        }
+        py::ssize_t len = PyTuple_GET_SIZE(static_cast<PyObject*>(t));
+        if (len != static_cast<py::ssize_t>(N)) {
+            PyErr_Format(PyExc_ValueError,
+                         "expected a sequence of length %zu, got %zd",
+                         N,
+                         len);
+            return -1;
+        }
+        return detail::_sequence_from_items(
+            reinterpret_cast<PyTupleObject*>(
+                static_cast<PyObject*>(t))->ob_item,
+            len,
+            out);
+    }
+};
+
+template<typename... Ts>
+struct to_python<std::tuple<Ts...>> {
+    static PyObject *f(const std::tuple<Ts...> &value) {
+        return detail::_tuple_to_python(value,
+                                        std::index_sequence_for<Ts...>{});
+    }
+};
+
+template<typename... Ts>
+struct from_python<std::tuple<Ts...>> {
+    static int f(PyObject *ob, std::tuple<Ts...> &out) {
+        return detail::_tuple_from_python(ob,
+                                          out,
+                                          std::index_sequence_for<Ts...>{});
+    }
+};
+
+template<typename A, typename B>
+struct to_python<std::pair<A, B>> {
+    static PyObject *f(const std::pair<A, B> &value) {
+        return detail::_tuple_to_python(value, std::index_sequence<0, 1>{});
+    }
+};
+
+template<typename A, typename B>
+struct from_python<std::pair<A, B>> {
+    static int f(PyObject *ob, std::pair<A, B> &out) {
+        return detail::_tuple_from_python(ob, out, std::index_sequence<0, 1>{});
+    }
+};
+
+template<typename T>
+struct to_python<std::optional<T>> {
+    static PyObject *f(const std::optional<T> &value) {
+        if (!value) {
+            Py_RETURN_NONE;
+        }
+        return to_python<T>::f(*value);
+    }
+};
+
+template<typename T>
+struct from_python<std::optional<T>> {
+    static int f(PyObject *ob, std::optional<T> &out) {
+        if (ob == Py_None) {
+            out.reset();
+            return 0;
+        }
+        T value;
+        if (from_python<T>::f(ob, value)) {
+            return -1;
+        }
+        out = std::move(value);
+        return 0;
+    }
+};
+
+template<typename K, typename V, typename C, typename A>
+struct to_python<std::map<K, V, C, A>> {
+    static PyObject *f(const std::map<K, V, C, A> &value) {
+        return detail::_map_to_python(value);
+    }
+};
+
+template<typename K, typename V, typename C, typename A>
+struct from_python<std::map<K, V, C, A>> {
+    static int f(PyObject *ob, std::map<K, V, C, A> &out) {
+        return detail::_map_from_python(ob, out);
+    }
+};
+
+template<typename K, typename V, typename H, typename E, typename A>
+struct to_python<std::unordered_map<K, V, H, E, A>> {
+    static PyObject *f(const std::unordered_map<K, V, H, E, A> &value) {
+        return detail::_map_to_python(value);
+    }
+};
+
+template<typename K, typename V, typename H, typename E, typename A>
+struct from_python<std::unordered_map<K, V, H, E, A>> {
+    static int f(PyObject *ob, std::unordered_map<K, V, H, E, A> &out) {
+        return detail::_map_from_python(ob, out);
+    }
+};
+}
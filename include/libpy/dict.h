@@ -0,0 +1,392 @@
+#pragma once
+#include <iterator>
+#include <tuple>
+#include <utility>
+
+#include "libpy/hashed_key.h"
+#include "libpy/object.h"
+#include "libpy/type.h"
+
+#define LIBPY_HAVE_DICT_KNOWN_HASH (PY_VERSION_HEX >= 0x03050000)
+
+namespace py {
+namespace dict {
+/**
+   A constant iterator over the items of a dict.
+
+   This yields `(key, value)` pairs of borrowed references using
+   `PyDict_Next`, so the value is found without a second lookup.
+   The dict must not be resized while it is being iterated.
+*/
+class const_iterator {
+private:
+    PyObject *ob;
+    py::ssize_t pos;
+    std::pair<py::object, py::object> item;
+
+    /**
+       Move to the next item in the dict. When the dict is exhausted `ob`
+       will be set to `nullptr` which makes this equal to the end marker.
+    */
+    inline void advance() {
+        PyObject *key;
+        PyObject *value;
+
+        if (ob && PyDict_Next(ob, &pos, &key, &value)) {
+            item.first = key;
+            item.second = value;
+        }
+        else {
+            ob = nullptr;
+            pos = 0;
+            item.first = nullptr;
+            item.second = nullptr;
+        }
+    }
+
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef std::pair<py::object, py::object> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type *pointer;
+    typedef const value_type &reference;
+
+    /**
+       Default constructor for cend.
+    */
+    const_iterator() : ob(nullptr), pos(0), item(nullptr, nullptr) {}
+
+    /**
+       Create an iterator at the start of a dict.
+
+       @param ob The dict to iterate over. This may be `nullptr` to create
+                 the end marker.
+    */
+    explicit const_iterator(PyObject *ob)
+        : ob(ob), pos(0), item(nullptr, nullptr) {
+        advance();
+    }
+
+    bool operator==(const const_iterator &other) const {
+        return ob == other.ob && pos == other.pos;
+    }
+
+    bool operator!=(const const_iterator &other) const {
+        return !(*this == other);
+    }
+
+    reference operator*() const {
+        return item;
+    }
+
+    pointer operator->() const {
+        return &item;
+    }
+
+    const_iterator &operator++() {
+        advance();
+        return *this;
+    }
+
+    const_iterator operator++(int) {
+        const_iterator tmp = *this;
+        advance();
+        return tmp;
+    }
+};
+
+/**
+   A subclass of `py::object` for optional dicts.
+*/
+class object : public py::object {
+private:
+    /**
+       Function called to verify that `ob` is a dict and
+       correctly raise a python exception otherwies.
+    */
+    void dict_check();
+public:
+    friend class py::tmpref<object>;
+
+    /**
+       Default constructor. This will set `ob` to nullptr.
+    */
+    object();
+
+    /**
+       Constructor from `PyObject*`. If `pob` is not a `dict` then
+       `ob` will be set to `nullptr`.
+    */
+    object(PyObject *pob);
+
+    /**
+       Constructor from `py::object`. If `pob` is not a `dict` then
+       `ob` will be set to `nullptr`.
+    */
+    object(const py::object &pob);
+
+    object(const object &cpfrom);
+    object(object &&mvfrom) noexcept;
+
+    /**
+       Constructor from `int`, `size_t` and `ssize_t`, these allocate new
+       empty dicts presized to hold `len` items without resizing.
+    */
+    explicit object(int len);
+    explicit object(std::size_t len);
+    explicit object(py::ssize_t len);
+
+    using py::object::operator=;
+
+    /**
+       Iteration over a dict yields `(key, value)` pairs of borrowed
+       references.
+    */
+    typedef dict::const_iterator const_iterator;
+    typedef const_iterator iterator;
+
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    iterator begin() const;
+    iterator end() const;
+
+    /**
+       Get the number of items in the dict.
+
+       This is equivalent to `len(this)`.
+
+       @return The length of the object or -1 if an exception occured.
+    */
+    py::ssize_t len() const;
+
+    using py::object::operator[];
+    using py::object::getitem;
+    using py::object::setitem;
+    using py::object::delitem;
+
+    /**
+       Lookup a value with a key whose hash is already known.
+
+       When `key` is not in the dict, this will return `py::object(nullptr)`
+       and raise a Python `KeyError`.
+
+       @param key The key to lookup.
+       @return    A borrowed reference to the value for `key`.
+    */
+    py::object operator[](const hashed_key &key) const;
+
+    /**
+       Alias for operator[].
+    */
+    py::object getitem(const hashed_key &key) const;
+
+    /**
+       Set the value for a key whose hash is already known.
+
+       This is equivalent to: `this[key] = value`.
+       This method does not steal a reference to `value`.
+
+       @param key   The key to set.
+       @param value The value to set.
+       @return      zero on success, non-zero if an exception occured.
+    */
+    int setitem(const hashed_key &key, const py::object &value) const;
+
+    /**
+       Delete a key whose hash is already known.
+
+       This is equivalent to: `del this[key]`.
+
+       @param key The key to delete.
+       @return    zero on success, non-zero if an exception occured.
+    */
+    int delitem(const hashed_key &key) const;
+
+    /**
+       Check if the dict contains a key whose hash is already known.
+
+       This is equivalent to: `key in this`.
+
+       @param key The key to look for.
+       @return    1 if `key` is in the dict, 0 if `key` is not in the dict,
+                  or -1 if an exception occured.
+    */
+    int contains(const hashed_key &key) const;
+
+    /**
+       Lookup a value without raising a `KeyError`.
+
+       This is equivalent to: `this.get(key)` except that a missing key
+       returns `py::object(nullptr)` without raising an exception. If
+       `nullptr` is returned, `py::err::occurred()` distinguishes a missing
+       key from a failed lookup.
+
+       @param key The key to lookup.
+       @return    A borrowed reference to the value for `key` or `nullptr`.
+    */
+    py::object get(const py::object &key) const;
+    py::object get(const hashed_key &key) const;
+
+    /**
+       Lookup a value, falling back to a default without raising a
+       `KeyError`.
+
+       This is equivalent to: `this.get(key, default_)`.
+
+       @param key      The key to lookup.
+       @param default_ The value to return when `key` is missing.
+       @return         A borrowed reference to the value for `key` or
+                       `default_`. This will be `nullptr` if an exception
+                       occured.
+    */
+    py::object get(const py::object &key, const py::object &default_) const;
+    py::object get(const hashed_key &key, const py::object &default_) const;
+
+    /**
+       Lookup a value, inserting a default if the key is missing.
+
+       This is equivalent to: `this.setdefault(key, default_)`.
+       This method does not steal a reference to `default_`.
+
+       @param key      The key to lookup.
+       @param default_ The value to insert when `key` is missing.
+       @return         A borrowed reference to the value for `key` after the
+                       insert or `nullptr` if an exception occured.
+    */
+    py::object setdefault(const py::object &key,
+                          const py::object &default_) const;
+    py::object setdefault(const hashed_key &key,
+                          const py::object &default_) const;
+
+    /**
+       Coerce to a `nonnull` object.
+
+       @see nonnull
+       @throws pyutil::bad_nonnull Thrown when `ob == nullptr`.
+       @return this converted to a `nonnull` object.
+    */
+    nonnull<object> as_nonnull() const;
+
+    /**
+       Create a temporary reference. This is a reference that will
+       decref the object when it is destroyed.
+
+       @return this converted into a tmpref.
+    */
+    tmpref<object> as_tmpref() &&;
+};
+
+/**
+   The type of Python `dict` objects.
+
+   This is equivalent to: `dict`.
+*/
+extern const type::object<dict::object> type;
+
+/**
+   Check if an object is an instance of `dict`.
+
+   @param t The object to check
+   @return  1 if `ob` is an instance of `dict`, 0 if `ob` is not an
+            instance of `dict`, -1 if an exception occured.
+*/
+template<typename T>
+inline int check(const T &t) {
+    if (!t.is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PyDict_Check(t);
+}
+
+inline int check(const nonnull<object>&) {
+    return 1;
+}
+
+/**
+   Check if an object is an instance of `dict` but not a subclass.
+
+   @param t The object to check
+   @return  1 if `ob` is an instance of `dict`, 0 if `ob` is not an
+            instance of `dict`, -1 if an exception occured.
+*/
+template<typename T>
+inline int checkexact(const T &t) {
+    if (!t.is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PyDict_CheckExact(t);
+}
+
+inline int checkexact(const nonnull<object>&) {
+    return 1;
+}
+}
+
+/**
+   A `py::dict::object` where `ob` is known to be nonnull.
+   This is used to skip null checks for performance.
+
+   This class should be used where users want to trade the ability to
+   write a nested expression for perfomance.
+*/
+template<>
+class nonnull<dict::object> : public dict::object {
+protected:
+    nonnull() = delete;
+    explicit nonnull(PyObject *ob) : dict::object(ob) {}
+public:
+    friend class object;
+
+    nonnull(const nonnull &cpfrom) : dict::object(cpfrom) {}
+    nonnull(nonnull &&mvfrom) noexcept : dict::object(mvfrom.ob) {
+        mvfrom.ob = nullptr;
+    }
+
+    nonnull &operator=(const nonnull &cpfrom) {
+        nonnull<dict::object> tmp(cpfrom);
+        return (*this = std::move(tmp));
+    }
+
+    nonnull &operator=(nonnull &&mvfrom) noexcept {
+        ob = mvfrom.ob;
+        mvfrom.ob = nullptr;
+        return *this;
+    }
+
+    /**
+       Get the number of items in the dict.
+
+       This is equivalent to `len(this)`.
+
+       @return The length of the object.
+    */
+    py::ssize_t len() const {
+        return reinterpret_cast<PyDictObject*>(ob)->ma_used;
+    }
+
+    const_iterator cbegin() const {
+        return const_iterator(ob);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(ob);
+    }
+};
+}
+
+namespace pyutils {
+template<typename T>
+struct typeformat;
+
+template<>
+struct typeformat<py::dict::object> {
+    static char_sequence<'O', '!'> cs;
+
+    template<typename T>
+    static inline auto make_arg(T &&t) {
+        return std::make_tuple(&PyDict_Type, std::forward<T>(t));
+    }
+};
+}
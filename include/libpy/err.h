@@ -1,10 +1,15 @@
 #pragma once
 
 #include <exception>
-#include <sstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 #include "libpy/object.h"
+#include "libpy/str_writer.h"
 #include "libpy/type.h"
 
 #define LIBPY_HAVE_INTERRUPTED_ERROR (PY_VERSION_HEX >= 0x03500000)
@@ -141,6 +146,7 @@ extern const exctype RecursionError;
 #endif
 extern const exctype ReferenceError;
 extern const exctype RuntimeError;
+extern const exctype StopIteration;
 extern const exctype SyntaxError;
 extern const exctype SystemError;
 extern const exctype TimeoutError;
@@ -158,10 +164,15 @@ extern const exctype IOError;
 
 /**
    Helper class used to raise exceptions with error messages.
+
+   Values written with `operator<<` are appended to a `py::str_writer` so
+   the message is built directly as a `str`. The exception is raised when
+   the builder is destroyed.
 */
-class msgbuilder : public std::stringstream {
+class msgbuilder {
 private:
     exctype type;
+    str_writer writer;
     bool fire;
 protected:
     friend msgbuilder raise(exctype type);
@@ -169,6 +180,19 @@ protected:
     msgbuilder(msgbuilder &&type) noexcept;
 public:
     ~msgbuilder();
+
+    /**
+       Append a value to the message.
+
+       @see str_writer::write_value
+       @param value The value to append.
+       @return      `*this` for chaining.
+    */
+    template<typename T>
+    inline msgbuilder &operator<<(const T &value) {
+        writer.write_value(value);
+        return *this;
+    }
 };
 
 /**
@@ -192,7 +216,7 @@ inline void clear() {
    Raise an exception with a message.
 
    @param type The type of exception to raise.
-   @return An `ostream` which will accumulate the message to send.
+   @return A `msgbuilder` which will accumulate the message to send.
 */
 msgbuilder raise(exctype type);
 
@@ -270,5 +294,159 @@ inline std::nullptr_t set_from_errno(exctype type,
     PyErr_SetFromErrnoWithFilenameObjects(type, filename1, filename2);
     return nullptr;
 }
+
+/**
+   The parts of a lazily formatted exception message.
+
+   @see raise_lazy
+*/
+class _lazy_message {
+public:
+    virtual ~_lazy_message() = default;
+
+    /**
+       Write the message.
+
+       @return zero on success, non-zero if an exception occured.
+    */
+    virtual int write(str_writer &writer) const = 0;
+
+    /**
+       Visit the objects held by the parts for the cyclic garbage
+       collector.
+    */
+    virtual int traverse(visitproc visit, void *arg) const = 0;
+};
+
+/* Helpers for `raise_lazy`. These are in a named namespace because
+   `raise_lazy` is instantiated in every translation unit that raises, and
+   all of them must share one definition.
+*/
+namespace detail {
+/**
+   How a message part is stored until the message is formatted. Objects
+   are kept alive with a new reference and `std::string_view`s are copied
+   into a `std::string`; everything else is copied as is.
+*/
+template<typename T>
+using _lazy_part_t = std::conditional_t<
+    std::is_base_of<py::object, std::decay_t<T>>::value,
+    ownedref<py::object>,
+    std::conditional_t<std::is_same<std::decay_t<T>, std::string_view>::value,
+                       std::string,
+                       std::decay_t<T>>>;
+
+template<typename T>
+inline int _lazy_part_traverse(const T &part, visitproc visit, void *arg) {
+    if constexpr (std::is_base_of<py::object, T>::value) {
+        if (part.is_nonnull()) {
+            return visit(part, arg);
+        }
+    }
+    return 0;
+}
+
+template<typename... Ts>
+class _lazy_message_impl : public _lazy_message {
+private:
+    std::tuple<Ts...> parts;
+
+public:
+    template<typename... Us>
+    _lazy_message_impl(Us&&... parts) : parts(std::forward<Us>(parts)...) {}
+
+    int write(str_writer &writer) const override {
+        std::apply([&](const auto&... part) { (writer << ... << part); },
+                   parts);
+        return writer.is_nonnull() ? 0 : -1;
+    }
+
+    int traverse(visitproc visit, void *arg) const override {
+        int status = 0;
+        std::apply([&](const auto&... part) {
+                ((status = status ? status :
+                  _lazy_part_traverse(part, visit, arg)), ...);
+            },
+            parts);
+        return status;
+    }
+};
+}
+
+/**
+   Wrap a lazy message in a Python object which is formatted the first
+   time it is converted to a `str`.
+
+   @param message The message to wrap.
+   @return        A new reference or nullptr.
+*/
+PyObject *_lazy_message_object(std::unique_ptr<_lazy_message> message);
+
+/**
+   Raise an exception whose message is formatted only when it is read.
+
+   `raise(type) << ...` builds the message `str` as soon as the builder is
+   destroyed. That work is wasted on paths which raise and then clear the
+   error, like probing one conversion before falling back to another.
+   Here the parts of the message are stored and the exception argument is
+   a placeholder object whose `str()` and `repr()` format the message the
+   first time they are called; the message compares and hashes like the
+   formatted `str`.
+
+   The placeholder is not a `str`: `args[0]` fails `isinstance(..., str)`
+   and has no `str` methods, so code which inspects the message should use
+   `str(exc)`. Pickling the placeholder produces the formatted `str`, so
+   the exception may still be sent to another process.
+
+   `py::object` parts are kept alive with a new reference,
+   `std::string_view` parts are copied into a `std::string`, and other
+   parts are copied as is. Objects are formatted when the message is first
+   read, not when it is raised, so the message shows any changes made to
+   them in between. Other non-owning parts, like a `const char*`, are
+   stored as the pointer, so what they point to must outlive the
+   exception; string literals always do. Pass a `std::string_view` or
+   `std::string` for text in a temporary buffer.
+
+   @param type  The type of exception to raise.
+   @param parts The parts of the message, written like `str_writer`.
+   @return      Always `nullptr` so users may write:
+                `return raise_lazy(...)`.
+*/
+template<typename... Ts>
+std::nullptr_t raise_lazy(exctype type, Ts&&... parts) {
+    std::unique_ptr<_lazy_message> message;
+    try {
+        message = std::make_unique<
+            detail::_lazy_message_impl<detail::_lazy_part_t<Ts>...>>(
+                std::forward<Ts>(parts)...);
+    }
+    catch (const std::bad_alloc&) {
+        return no_memory();
+    }
+    PyObject *ob = _lazy_message_object(std::move(message));
+    if (ob) {
+        PyErr_SetObject(type, ob);
+        Py_DECREF(ob);
+    }
+    return nullptr;
+}
+
+/**
+   Raise a preallocated instance of `type` with no arguments.
+
+   Sentinel errors like `StopIteration` or a `KeyError` which a caller is
+   expected to catch are raised without allocating a new exception. An
+   instance is only reused when nothing else holds a reference to it and
+   no state was added to it after it was raised, like attributes, notes,
+   a cause, or the `value` of a `StopIteration`; otherwise a new instance
+   replaces it. Its traceback and context are reset before it is raised
+   again. A small number of types are cached; other types are raised with
+   `PyErr_SetNone`.
+
+   @param type The type of exception to raise.
+   @return     Always `nullptr` so users may write:
+               `return raise_sentinel(...)`.
+*/
+std::nullptr_t raise_sentinel(exctype type);
 }
 }
@@ -0,0 +1,389 @@
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+#include <libpy/object.h>
+
+namespace py {
+/* `object.h` includes this header to define the float literal, so it may
+   be reached while `box.h`, `long.h`, or `type.h` are still being
+   processed. Their definitions are included at the end of this header;
+   only declarations are used before then.
+*/
+inline bool read_small_int(PyObject *ob, long long &out);
+
+namespace long_ {
+class object;
+}
+
+namespace type {
+template<typename Instance>
+class object;
+}
+
+namespace float_ {
+class object;
+
+/**
+   Fill the slot for a float literal the first time it is used.
+
+   @param slot    The slot for the literal.
+   @param literal The characters of the literal.
+   @return        `slot`.
+*/
+const object &_fill_literal(object &slot, const char *literal);
+}
+
+/**
+   Operator overload for float objects.
+
+   Each literal is stored in its own static slot so using a literal does
+   not need to hash or look up the value.
+*/
+template<char... cs>
+const float_::object &operator""_p();
+
+namespace float_ {
+namespace detail {
+    /**
+       Template that selects float_::object if O is a float_::object or a
+       long_::object else return py::object.
+
+       This will work for subclasses like nonnull or tmpref.
+    */
+    template<typename O>
+    using maybe_float_t = typename std::conditional<
+        std::is_base_of<object, O>::value ||
+        std::is_base_of<long_::object, O>::value,
+        object,
+        py::object>::type;
+
+    /**
+       Read an operand of a float operator as a double without going
+       through the number protocol. This accepts exact `float`s and exact
+       `int`s which fit in two digits.
+    */
+    inline bool read_double(PyObject *ob, double &out) {
+        if (!ob) {
+            return false;
+        }
+        if (PyFloat_CheckExact(ob)) {
+            out = PyFloat_AS_DOUBLE(ob);
+            return true;
+        }
+        long long value;
+        if (PyLong_CheckExact(ob) && read_small_int(ob, value)) {
+            out = static_cast<double>(value);
+            return true;
+        }
+        return false;
+    }
+
+    /* C++ implementations of the binary operators. Each returns false
+       when Python would raise, leaving the operation to the number
+       protocol.
+    */
+
+    inline bool float_add(double a, double b, double &out) {
+        out = a + b;
+        return true;
+    }
+
+    inline bool float_sub(double a, double b, double &out) {
+        out = a - b;
+        return true;
+    }
+
+    inline bool float_mul(double a, double b, double &out) {
+        out = a * b;
+        return true;
+    }
+
+    inline bool float_div(double a, double b, double &out) {
+        if (!b) {
+            return false;
+        }
+        out = a / b;
+        return true;
+    }
+
+    inline bool float_rem(double a, double b, double &out) {
+        if (!b) {
+            return false;
+        }
+        // Python's `%` takes the sign of the divisor, including for zero
+        out = std::fmod(a, b);
+        if (out) {
+            if ((b < 0) != (out < 0)) {
+                out += b;
+            }
+        }
+        else {
+            out = std::copysign(0.0, b);
+        }
+        return true;
+    }
+}
+
+class object : public py::object {
+private:
+    /**
+       Function called to verify that `ob` is a float and
+       correctly raise a python exception otherwies.
+    */
+    void float_check();
+
+    /**
+       Compute a binary operator in C++ if `ob` is an exact `float` and
+       `other` can be read with `read_double`.
+    */
+    template<bool op(double, double, double&), typename T>
+    inline bool compute(const T &other, double &out) const {
+        double rhs;
+        return ob && PyFloat_CheckExact(ob) &&
+            detail::read_double(other, rhs) &&
+            op(PyFloat_AS_DOUBLE(ob), rhs, out);
+    }
+
+    template<PyObject *func(PyObject*, PyObject*),
+             bool op(double, double, double&),
+             typename T>
+    inline PyObject *double_binary_func(const T &other) const {
+        if (!pyutils::all_nonnull(*this, other)) {
+            pyutils::failed_null_check();
+            return nullptr;
+        }
+        double result;
+        if (compute<op>(other, result)) {
+            return PyFloat_FromDouble(result);
+        }
+        return func(ob, other);
+    }
+
+    /**
+       Apply a binary operator to a temporary. If this is the only
+       reference to the temporary, the result is written into it instead
+       of allocating a new `float`.
+    */
+    template<PyObject *func(PyObject*, PyObject*),
+             bool op(double, double, double&),
+             typename T>
+    static tmpref<detail::maybe_float_t<T>>
+    reuse_binary_func(tmpref<object> &&self, const T &other) {
+        double result;
+        if (self.ob && Py_REFCNT(self.ob) == 1 &&
+            self.compute<op>(other, result)) {
+            reinterpret_cast<PyFloatObject*>(self.ob)->ob_fval = result;
+            PyObject *out = self;
+            std::move(self).invalidate();
+            return out;
+        }
+        return self.double_binary_func<func, op>(other);
+    }
+
+public:
+    friend tmpref<object>;
+    friend const object &_fill_literal(object &slot, const char *literal);
+
+    /**
+       Default constructor. This will set `ob` to nullptr.
+    */
+    object();
+
+    /**
+       Constructor from C++ numeric types.
+
+       This constructor is explicit because the user must manually
+       decref the object. If an expression was implicitly upcast to
+       float_::object there could be a leak.
+
+       @param d The numeric type to coerce into a python `float`.
+    */
+    template<typename D,
+             typename = std::enable_if_t<std::is_arithmetic<D>::value>>
+    explicit object(D d) : py::object(PyFloat_FromDouble(d)) {}
+
+    /**
+       Constructor from `PyObject*`. If `pob` is not a `float` then
+       `ob` will be set to `nullptr`.
+    */
+    object(PyObject *pob);
+
+    /**
+       Constructor from `py::object`. If `pob` is not a `float` then
+       `ob` will be set to `nullptr`.
+    */
+    object(const py::object &pob);
+
+    object(const object &cpfrom);
+    object(object &&mvfrom) noexcept;
+
+    using py::object::operator=;
+
+    /**
+       The value of the float. This reads the value directly from the
+       object.
+
+       @return The value, or -1 with an exception raised if `ob` is
+               nullptr.
+    */
+    inline double as_double() const {
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return -1;
+        }
+        return PyFloat_AS_DOUBLE(ob);
+    }
+
+    nonnull<object> as_nonnull() const;
+    tmpref<object> as_tmpref() &&;
+
+    template<typename T>
+    tmpref<detail::maybe_float_t<T>> operator+(const T &other) const {
+        return double_binary_func<PyNumber_Add, detail::float_add>(other);
+    }
+
+    template<typename T>
+    tmpref<detail::maybe_float_t<T>> operator-(const T &other) const {
+        return double_binary_func<PyNumber_Subtract, detail::float_sub>(other);
+    }
+
+    template<typename T>
+    tmpref<detail::maybe_float_t<T>> operator*(const T &other) const {
+        return double_binary_func<PyNumber_Multiply, detail::float_mul>(other);
+    }
+
+    template<typename T>
+    tmpref<detail::maybe_float_t<T>> operator/(const T &other) const {
+        return double_binary_func<PyNumber_TrueDivide,
+                                  detail::float_div>(other);
+    }
+
+    template<typename T>
+    tmpref<detail::maybe_float_t<T>> operator%(const T &other) const {
+        return double_binary_func<PyNumber_Remainder, detail::float_rem>(other);
+    }
+
+    /* Operators on a temporary, like the intermediate results of
+       `a * b + c`, reuse its storage.
+    */
+
+    template<typename T>
+    friend tmpref<detail::maybe_float_t<T>> operator+(tmpref<object> &&self,
+                                              const T &other) {
+        return reuse_binary_func<PyNumber_Add, detail::float_add>(
+            std::move(self), other);
+    }
+
+    template<typename T>
+    friend tmpref<detail::maybe_float_t<T>> operator-(tmpref<object> &&self,
+                                              const T &other) {
+        return reuse_binary_func<PyNumber_Subtract, detail::float_sub>(
+            std::move(self), other);
+    }
+
+    template<typename T>
+    friend tmpref<detail::maybe_float_t<T>> operator*(tmpref<object> &&self,
+                                              const T &other) {
+        return reuse_binary_func<PyNumber_Multiply, detail::float_mul>(
+            std::move(self), other);
+    }
+
+    template<typename T>
+    friend tmpref<detail::maybe_float_t<T>> operator/(tmpref<object> &&self,
+                                              const T &other) {
+        return reuse_binary_func<PyNumber_TrueDivide, detail::float_div>(
+            std::move(self), other);
+    }
+
+    template<typename T>
+    friend tmpref<detail::maybe_float_t<T>> operator%(tmpref<object> &&self,
+                                              const T &other) {
+        return reuse_binary_func<PyNumber_Remainder, detail::float_rem>(
+            std::move(self), other);
+    }
+
+    tmpref<object> operator-() const;
+    tmpref<object> operator+() const;
+    tmpref<object> abs() const;
+};
+
+/**
+   The type of Python `float` objects.
+
+   This is equivalent to: `float`.
+*/
+extern const type::object<float_::object> type;
+
+/**
+   Check if an object is an instance of `float`.
+
+   @param t The object to check
+   @return  1 if `ob` is an instance of `float`, 0 if `ob` is not an
+            instance of `float`, -1 if an exception occured.
+*/
+template<typename T>
+inline int check(const T &t) {
+    if (!t.is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PyFloat_Check(t);
+}
+
+inline int check(const nonnull<object>&) {
+    return 1;
+}
+
+/**
+   Check if an object is an instance of `float` but not a subclass.
+
+   @param t The object to check
+   @return  1 if `ob` is an instance of `float`, 0 if `ob` is not an
+            instance of `float`, -1 if an exception occured.
+*/
+template<typename T>
+inline int checkexact(const T &t) {
+    if (!t.is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PyFloat_CheckExact(t);
+}
+
+inline int checkexact(const nonnull<object>&) {
+    return 1;
+}
+}
+
+template<char... cs>
+const float_::object &operator""_p() {
+    static constexpr char literal[] = {cs..., '\0'};
+    static float_::object slot;
+    if (slot.is_nonnull()) {
+        return slot;
+    }
+    return float_::_fill_literal(slot, literal);
+}
+}
+
+namespace pyutils {
+template<typename T>
+struct typeformat;
+
+template<>
+struct typeformat<py::float_::object> {
+    static char_sequence<'O', '!'> cs;
+
+    template<typename T>
+    static inline auto make_arg(T &&t) {
+        return std::make_tuple(&PyFloat_Type, std::forward<T>(t));
+    }
+};
+}
+
+#include <libpy/box.h>
+#include <libpy/long.h>
+#include <libpy/type.h>
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "libpy/object.h"
+
+namespace py {
+/**
+   A key paired with its precomputed hash.
+
+   Containers that accept a `hashed_key` use the known-hash entry points of
+   the CPython API so the same key may be looked up in many containers while
+   only being hashed a single time.
+
+   Like `py::object`, this does not own a reference to the key.
+*/
+class hashed_key {
+private:
+    py::object ob;
+    hash_t hash_value;
+
+public:
+    /**
+       Default constructor. The key will be `nullptr`.
+    */
+    hashed_key() : ob(nullptr), hash_value(-1) {}
+
+    /**
+       Hash `key` and store the result.
+
+       If `key` is `nullptr` or cannot be hashed, the `hashed_key` will wrap
+       `nullptr` and a Python exception will be raised.
+
+       @param key The key to hash.
+    */
+    hashed_key(const py::object &key) : ob(key), hash_value(key.hash()) {
+        if (hash_value == -1) {
+            ob = nullptr;
+        }
+    }
+
+    /**
+       Pair a key with a hash that was computed elsewhere.
+
+       @param key  The key.
+       @param hash The hash of `key`. This must be equal to `key.hash()`.
+    */
+    hashed_key(const py::object &key, hash_t hash)
+        : ob(key), hash_value(hash) {}
+
+    /**
+       The key being hashed.
+    */
+    inline const py::object &key() const {
+        return ob;
+    }
+
+    /**
+       The precomputed hash of the key.
+    */
+    inline hash_t hash() const {
+        return hash_value;
+    }
+
+    /**
+       Check if the underlying key is nonnull.
+
+       @return true if the key is not `nullptr` else false.
+    */
+    inline bool is_nonnull() const {
+        return ob.is_nonnull();
+    }
+
+    /**
+       coersion to PyObject*
+    */
+    inline operator PyObject*() const {
+        return ob;
+    }
+};
+}
@@ -0,0 +1,522 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+#include "libpy/buffer.h"
+#include "libpy/object.h"
+
+namespace py {
+/**
+   Vectorized kernels over the elements of buffers.
+
+   Each kernel is compiled once per instruction set and the best one the
+   CPU supports is picked at startup. Kernels are provided for `float`,
+   `double`, `std::int32_t` and `std::int64_t` elements. Integer arithmetic
+   wraps on overflow.
+
+   The functions that take a raw pointer do no validation. The
+   `buffer_view` overloads check their inputs and raise a Python exception
+   on failure. 1 dimensional views may be strided; views with more
+   dimensions must be C-contiguous and are treated as flat.
+*/
+namespace kernels {
+/**
+   The instruction sets that kernels are compiled for.
+*/
+enum class target {
+    /**
+       The compiler's default instruction set, SSE2 on x86-64.
+    */
+    baseline,
+    avx2,
+    avx512,
+};
+
+/**
+   Check if the CPU can run kernels compiled for a target.
+
+   @param t The target to check.
+   @return  true if `t` is supported.
+*/
+bool supported(target t);
+
+/**
+   Get the target that kernels are currently dispatched to.
+
+   @return The active target.
+*/
+target active_target();
+
+/**
+   Change the target that kernels are dispatched to. This is mostly useful
+   for testing and benchmarking the narrower instruction sets.
+
+   @param t The target to use.
+   @return  zero on success, non-zero if `t` is not supported by the CPU and
+            a Python exception was raised.
+*/
+int set_target(target t);
+
+/**
+   Check if kernels are provided for an element type.
+*/
+template<typename T>
+struct is_kernel_type
+    : std::integral_constant<bool,
+                             std::is_same<T, float>::value ||
+                             std::is_same<T, double>::value ||
+                             std::is_same<T, std::int32_t>::value ||
+                             std::is_same<T, std::int64_t>::value> {};
+
+/**
+   Sum the elements of an array. Floating point sums use compensated
+   summation.
+
+   @param data   A pointer to the first element.
+   @param len    The number of elements.
+   @param stride The number of bytes between elements.
+   @return       The sum of the elements.
+*/
+template<typename T>
+T sum(const T *data, py::ssize_t len, py::ssize_t stride = sizeof(T));
+
+/**
+   Find the smallest element of an array. If any element is NaN the result
+   is NaN.
+
+   @param data   A pointer to the first element.
+   @param len    The number of elements. This must be at least 1.
+   @param stride The number of bytes between elements.
+   @return       The smallest element.
+*/
+template<typename T>
+T min(const T *data, py::ssize_t len, py::ssize_t stride = sizeof(T));
+
+/**
+   Find the largest element of an array. If any element is NaN the result
+   is NaN.
+
+   @param data   A pointer to the first element.
+   @param len    The number of elements. This must be at least 1.
+   @param stride The number of bytes between elements.
+   @return       The largest element.
+*/
+template<typename T>
+T max(const T *data, py::ssize_t len, py::ssize_t stride = sizeof(T));
+
+/**
+   Find the index of the first occurrence of the smallest element of an
+   array. If any element is NaN the index of the first NaN is returned.
+
+   @param data   A pointer to the first element.
+   @param len    The number of elements. This must be at least 1.
+   @param stride The number of bytes between elements.
+   @return       The index of the smallest element.
+*/
+template<typename T>
+py::ssize_t argmin(const T *data,
+                   py::ssize_t len,
+                   py::ssize_t stride = sizeof(T));
+
+/**
+   Find the index of the first occurrence of the largest element of an
+   array. If any element is NaN the index of the first NaN is returned.
+
+   @param data   A pointer to the first element.
+   @param len    The number of elements. This must be at least 1.
+   @param stride The number of bytes between elements.
+   @return       The index of the largest element.
+*/
+template<typename T>
+py::ssize_t argmax(const T *data,
+                   py::ssize_t len,
+                   py::ssize_t stride = sizeof(T));
+
+/**
+   Compute the mean of a floating point array with compensated summation.
+
+   @param data   A pointer to the first element.
+   @param len    The number of elements. This must be at least 1.
+   @param stride The number of bytes between elements.
+   @return       The mean of the elements.
+*/
+template<typename T>
+T mean(const T *data, py::ssize_t len, py::ssize_t stride = sizeof(T));
+
+/**
+   Compute the variance of a floating point array. This makes two passes
+   over the data and uses compensated summation for both.
+
+   @param data   A pointer to the first element.
+   @param len    The number of elements. This must be greater than `ddof`.
+   @param stride The number of bytes between elements.
+   @param ddof   The delta degrees of freedom. The sum of squared deviations
+                 is divided by `len - ddof`.
+   @return       The variance of the elements.
+*/
+template<typename T>
+T variance(const T *data,
+           py::ssize_t len,
+           py::ssize_t stride = sizeof(T),
+           py::ssize_t ddof = 0);
+
+/**
+   Compute `out[ix] = a[ix] + b[ix]`. `out` must be contiguous but may be
+   the same array as `a` or `b`.
+*/
+template<typename T>
+void add(const T *a,
+         py::ssize_t a_stride,
+         const T *b,
+         py::ssize_t b_stride,
+         T *out,
+         py::ssize_t len);
+
+/**
+   Compute `out[ix] = a[ix] * b[ix]`. `out` must be contiguous but may be
+   the same array as `a` or `b`.
+*/
+template<typename T>
+void mul(const T *a,
+         py::ssize_t a_stride,
+         const T *b,
+         py::ssize_t b_stride,
+         T *out,
+         py::ssize_t len);
+
+/**
+   Compute `out[ix] = a[ix] <op> b[ix]`. `out` must be contiguous.
+*/
+template<typename T>
+void compare(const T *a,
+             py::ssize_t a_stride,
+             const T *b,
+             py::ssize_t b_stride,
+             bool *out,
+             py::ssize_t len,
+             compareop op);
+
+/**
+   Allocate a new contiguous buffer with the same shape as another buffer.
+
+   The result is a `memoryview` over a `bytearray` with the format of `T`.
+   `memoryview` cannot have a zero in a multi-dimensional shape, so the
+   result for an empty buffer is always one dimensional with length zero.
+
+   @param like The buffer to take the shape from.
+   @param data Set to the first element of the new buffer.
+   @return     The new buffer or `nullptr` with a Python exception raised.
+*/
+template<typename T>
+tmpref<py::object> empty_like(const Py_buffer &like, T *&data);
+
+namespace detail {
+/**
+   Get the elements of a view as a pointer, length and stride.
+*/
+template<typename T, int ndim>
+int _flatten(const buffer_view<T, ndim> &view,
+             const std::remove_const_t<T> *&data,
+             py::ssize_t &len,
+             py::ssize_t &stride) {
+    static_assert(is_kernel_type<std::remove_const_t<T>>::value,
+                  "no kernels are provided for this element type");
+
+    if (!view.is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    data = view.data();
+    if (ndim == 1) {
+        len = view.shape(0);
+        stride = view.stride(0);
+        return 0;
+    }
+    if (!view.is_contiguous()) {
+        PyErr_SetString(PyExc_ValueError,
+                        "kernels over multi-dimensional buffers require a "
+                        "C-contiguous buffer");
+        return -1;
+    }
+    len = view.size();
+    stride = sizeof(T);
+    return 0;
+}
+
+/**
+   Get the elements of a view that is being reduced to a single value.
+*/
+template<typename T, int ndim>
+int _flatten_nonempty(const buffer_view<T, ndim> &view,
+                      const std::remove_const_t<T> *&data,
+                      py::ssize_t &len,
+                      py::ssize_t &stride,
+                      const char *name) {
+    if (_flatten(view, data, len, stride)) {
+        return -1;
+    }
+    if (!len) {
+        PyErr_Format(PyExc_ValueError, "%s of an empty buffer", name);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+   Validate the operands of an elementwise kernel and allocate the result.
+*/
+template<typename R, typename T, typename U, int ndim>
+tmpref<py::object> _binary_prepare(const buffer_view<T, ndim> &a,
+                                   const buffer_view<U, ndim> &b,
+                                   const std::remove_const_t<T> *&a_data,
+                                   py::ssize_t &a_stride,
+                                   const std::remove_const_t<T> *&b_data,
+                                   py::ssize_t &b_stride,
+                                   R *&out,
+                                   py::ssize_t &len) {
+    static_assert(std::is_same<std::remove_const_t<T>,
+                               std::remove_const_t<U>>::value,
+                  "operands must have the same element type");
+    py::ssize_t b_len;
+
+    if (_flatten(a, a_data, len, a_stride) ||
+        _flatten(b, b_data, b_len, b_stride)) {
+        return nullptr;
+    }
+    for (int dim = 0; dim < ndim; ++dim) {
+        if (a.shape(dim) != b.shape(dim)) {
+            PyErr_SetString(PyExc_ValueError,
+                            "operands must have the same shape");
+            return nullptr;
+        }
+    }
+    return empty_like(a.raw(), out);
+}
+}
+
+/**
+   Sum the elements of a buffer.
+
+   @param view The buffer to sum.
+   @param out  Set to the sum.
+   @return     zero on success, non-zero if an exception occured.
+*/
+template<typename T, int ndim>
+int sum(const buffer_view<T, ndim> &view, std::remove_const_t<T> &out) {
+    const std::remove_const_t<T> *data;
+    py::ssize_t len;
+    py::ssize_t stride;
+
+    if (detail::_flatten(view, data, len, stride)) {
+        return -1;
+    }
+    out = sum(data, len, stride);
+    return 0;
+}
+
+/**
+   Find the smallest element of a buffer.
+
+   @param view The buffer to search.
+   @param out  Set to the smallest element.
+   @return     zero on success, non-zero if an exception occured.
+*/
+template<typename T, int ndim>
+int min(const buffer_view<T, ndim> &view, std::remove_const_t<T> &out) {
+    const std::remove_const_t<T> *data;
+    py::ssize_t len;
+    py::ssize_t stride;
+
+    if (detail::_flatten_nonempty(view, data, len, stride, "min")) {
+        return -1;
+    }
+    out = min(data, len, stride);
+    return 0;
+}
+
+/**
+   Find the largest element of a buffer.
+
+   @param view The buffer to search.
+   @param out  Set to the largest element.
+   @return     zero on success, non-zero if an exception occured.
+*/
+template<typename T, int ndim>
+int max(const buffer_view<T, ndim> &view, std::remove_const_t<T> &out) {
+    const std::remove_const_t<T> *data;
+    py::ssize_t len;
+    py::ssize_t stride;
+
+    if (detail::_flatten_nonempty(view, data, len, stride, "max")) {
+        return -1;
+    }
+    out = max(data, len, stride);
+    return 0;
+}
+
+/**
+   Find the flat index of the smallest element of a buffer.
+
+   @param view The buffer to search.
+   @return     The index or -1 if an exception occured.
+*/
+template<typename T, int ndim>
+py::ssize_t argmin(const buffer_view<T, ndim> &view) {
+    const std::remove_const_t<T> *data;
+    py::ssize_t len;
+    py::ssize_t stride;
+
+    if (detail::_flatten_nonempty(view, data, len, stride, "argmin")) {
+        return -1;
+    }
+    return argmin(data, len, stride);
+}
+
+/**
+   Find the flat index of the largest element of a buffer.
+
+   @param view The buffer to search.
+   @return     The index or -1 if an exception occured.
+*/
+template<typename T, int ndim>
+py::ssize_t argmax(const buffer_view<T, ndim> &view) {
+    const std::remove_const_t<T> *data;
+    py::ssize_t len;
+    py::ssize_t stride;
+
+    if (detail::_flatten_nonempty(view, data, len, stride, "argmax")) {
+        return -1;
+    }
+    return argmax(data, len, stride);
+}
+
+/**
+   Compute the mean of a floating point buffer.
+
+   @param view The buffer to average.
+   @param out  Set to the mean.
+   @return     zero on success, non-zero if an exception occured.
+*/
+template<typename T, int ndim>
+int mean(const buffer_view<T, ndim> &view, std::remove_const_t<T> &out) {
+    static_assert(std::is_floating_point<T>::value,
+                  "mean requires floating point elements");
+    const std::remove_const_t<T> *data;
+    py::ssize_t len;
+    py::ssize_t stride;
+
+    if (detail::_flatten_nonempty(view, data, len, stride, "mean")) {
+        return -1;
+    }
+    out = mean(data, len, stride);
+    return 0;
+}
+
+/**
+   Compute the variance of a floating point buffer.
+
+   @param view The buffer to compute the variance of.
+   @param out  Set to the variance.
+   @param ddof The delta degrees of freedom.
+   @return     zero on success, non-zero if an exception occured.
+*/
+template<typename T, int ndim>
+int variance(const buffer_view<T, ndim> &view,
+             std::remove_const_t<T> &out,
+             py::ssize_t ddof = 0) {
+    static_assert(std::is_floating_point<T>::value,
+                  "variance requires floating point elements");
+    const std::remove_const_t<T> *data;
+    py::ssize_t len;
+    py::ssize_t stride;
+
+    if (detail::_flatten(view, data, len, stride)) {
+        return -1;
+    }
+    if (len <= ddof) {
+        PyErr_SetString(PyExc_ValueError,
+                        "variance requires more elements than ddof");
+        return -1;
+    }
+    out = variance(data, len, stride, ddof);
+    return 0;
+}
+
+/**
+   Add two buffers elementwise.
+
+   @param a The left hand side.
+   @param b The right hand side. This must have the same shape as `a`.
+   @return  A new buffer with the same shape as `a` or `nullptr`.
+*/
+template<typename T, typename U, int ndim>
+tmpref<py::object> add(const buffer_view<T, ndim> &a,
+                       const buffer_view<U, ndim> &b) {
+    const std::remove_const_t<T> *a_data = nullptr;
+    const std::remove_const_t<T> *b_data = nullptr;
+    std::remove_const_t<T> *out_data = nullptr;
+    py::ssize_t a_stride = 0;
+    py::ssize_t b_stride = 0;
+    py::ssize_t len = 0;
+
+    tmpref<py::object> out = detail::_binary_prepare(
+        a, b, a_data, a_stride, b_data, b_stride, out_data, len);
+    if (out.is_nonnull()) {
+        add(a_data, a_stride, b_data, b_stride, out_data, len);
+    }
+    return out;
+}
+
+/**
+   Multiply two buffers elementwise.
+
+   @param a The left hand side.
+   @param b The right hand side. This must have the same shape as `a`.
+   @return  A new buffer with the same shape as `a` or `nullptr`.
+*/
+template<typename T, typename U, int ndim>
+tmpref<py::object> mul(const buffer_view<T, ndim> &a,
+                       const buffer_view<U, ndim> &b) {
+    const std::remove_const_t<T> *a_data = nullptr;
+    const std::remove_const_t<T> *b_data = nullptr;
+    std::remove_const_t<T> *out_data = nullptr;
+    py::ssize_t a_stride = 0;
+    py::ssize_t b_stride = 0;
+    py::ssize_t len = 0;
+
+    tmpref<py::object> out = detail::_binary_prepare(
+        a, b, a_data, a_stride, b_data, b_stride, out_data, len);
+    if (out.is_nonnull()) {
+        mul(a_data, a_stride, b_data, b_stride, out_data, len);
+    }
+    return out;
+}
+
+/**
+   Compare two buffers elementwise.
+
+   @param a  The left hand side.
+   @param b  The right hand side. This must have the same shape as `a`.
+   @param op The comparison to apply.
+   @return   A new buffer of `bool` with the same shape as `a` or `nullptr`.
+*/
+template<typename T, typename U, int ndim>
+tmpref<py::object> compare(const buffer_view<T, ndim> &a,
+                           const buffer_view<U, ndim> &b,
+                           compareop op) {
+    const std::remove_const_t<T> *a_data = nullptr;
+    const std::remove_const_t<T> *b_data = nullptr;
+    bool *out_data = nullptr;
+    py::ssize_t a_stride = 0;
+    py::ssize_t b_stride = 0;
+    py::ssize_t len = 0;
+
+    tmpref<py::object> out = detail::_binary_prepare(
+        a, b, a_data, a_stride, b_data, b_stride, out_data, len);
+    if (out.is_nonnull()) {
+        compare(a_data, a_stride, b_data, b_stride, out_data, len, op);
+    }
+    return out;
+}
+}
+}
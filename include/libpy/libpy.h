@@ -1,7 +1,20 @@
 #pragma once
 
+#include "libpy/box.h"
+#include "libpy/buffer.h"
+#include "libpy/bytes_writer.h"
+#include "libpy/columns.h"
+#include "libpy/convert.h"
+#include "libpy/dict.h"
 #include "libpy/err.h"
+#include "libpy/float.h"
+#include "libpy/hashed_key.h"
 #include "libpy/object.h"
+#include "libpy/policy.h"
+#include "libpy/set.h"
+#include "libpy/slice.h"
+#include "libpy/str.h"
+#include "libpy/str_writer.h"
 #include "libpy/tuple.h"
 #include "libpy/type.h"
 #include "libpy/list.h"
@@ -1,7 +1,13 @@
 #pragma once
+#include <cstring>
+#include <iterator>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 
+#include "libpy/box.h"
 #include "libpy/object.h"
+#include "libpy/slice.h"
 #include "libpy/type.h"
 
 namespace py {
@@ -24,6 +30,12 @@ protected:
     return reinterpret_cast<py::object*>(
         reinterpret_cast<PyListObject* const>(ob)->ob_item);
 }
+
+    /**
+       Set the length of the list. The storage must already be reserved
+       and every item below `len` must be filled.
+    */
+    void set_len(py::ssize_t len) const;
 public:
     friend class py::tmpref<object>;
 
@@ -101,7 +113,7 @@ public:
     template<typename I,
              typename = std::enable_if_t<std::is_integral<I>::value>>
     py::object getitem(I idx) const {
-        return *this[idx];
+        return (*this)[idx];
     }
 
     /**
@@ -180,6 +192,182 @@ public:
         return PyList_Append(*this, elem);
     }
 
+    /**
+       Make sure the list can hold at least `capacity` elements without
+       reallocating its storage. This does not change the length.
+
+       @param capacity The number of elements to make room for.
+       @return -1 on failure, otherwise zero.
+    */
+    int reserve(py::ssize_t capacity) const;
+
+    /**
+       Box and append each element of a contiguous C++ array.
+
+       The storage is grown at most once and the elements are boxed
+       directly into it with `py::box_range`. If any element fails to box
+       the list is left unchanged.
+
+       @param data The values to append.
+       @param len  The number of values in `data`.
+       @return -1 on failure, otherwise zero.
+    */
+    template<typename T>
+    int extend(const T *data, py::ssize_t len) const {
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return -1;
+        }
+
+        PyListObject *l = reinterpret_cast<PyListObject*>(ob);
+        py::ssize_t size = Py_SIZE(ob);
+        if (len > PY_SSIZE_T_MAX - size) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        py::ssize_t needed = size + len;
+        if (needed > l->allocated) {
+            // overallocate like `list.append` so repeated extends are
+            // amortized, but only as far as a `Py_ssize_t` can count
+            py::ssize_t extra = (needed >> 3) + 6;
+            if (reserve(needed > PY_SSIZE_T_MAX - extra ?
+                        needed :
+                        needed + extra)) {
+                return -1;
+            }
+        }
+        PyObject **items = l->ob_item;
+        if (py::box_range(items + size, data, len)) {
+            return -1;
+        }
+        set_len(size + len);
+        return 0;
+    }
+
+    /**
+       Box and append each element of a contiguous C++ range, for example
+       a `std::vector` or `std::array`.
+
+       @param range The values to append.
+       @return -1 on failure, otherwise zero.
+    */
+    template<typename R,
+             typename = decltype(std::data(std::declval<const R&>()))>
+    int extend(const R &range) const {
+        return extend(std::data(range),
+                      static_cast<py::ssize_t>(std::size(range)));
+    }
+
+    /**
+       Unbox each element of the list into a `std::vector`.
+
+       `out` is resized to the length of the list and overwritten, so a
+       buffer may be reused across calls without reallocating. Exact `int`
+       and `float` elements are read directly; see `py::unbox` for the
+       conversion rules.
+
+       @param out The vector to write the values into.
+       @return -1 on failure, otherwise zero. On failure the contents of
+               `out` are unspecified.
+    */
+    template<typename T>
+    int to_vector(std::vector<T> &out) const {
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return -1;
+        }
+
+        py::ssize_t len = PyList_GET_SIZE(ob);
+        out.resize(len);
+        for (py::ssize_t ix = 0; ix < len; ++ix) {
+            // converting a non-exact element may run Python code which
+            // resizes the list
+            if (ix >= PyList_GET_SIZE(ob)) {
+                PyErr_SetString(PyExc_RuntimeError,
+                                "list changed size during unboxing");
+                return -1;
+            }
+            T value;
+            if (py::unbox(PyList_GET_ITEM(ob, ix), value)) {
+                return -1;
+            }
+            out[ix] = value;
+        }
+        return 0;
+    }
+
+    /**
+       View `this[start:stop:step]` without copying.
+
+       Bounds follow Python's slicing rules: negative bounds count from the
+       end and out of range bounds are clipped. Pass `py::slice_end` as
+       `stop` to run to the end of the list, or to the front with a negative
+       step.
+
+       The view is invalidated if the list is resized.
+
+       @param start The start bound.
+       @param stop  The stop bound.
+       @param step  The step, which may not be zero.
+       @return      A borrowed view of the items. If `step` is zero or `ob`
+                    is `nullptr` the view is not valid and a Python
+                    exception is raised.
+    */
+    item_span slice(py::ssize_t start,
+                    py::ssize_t stop = slice_end,
+                    py::ssize_t step = 1) const;
+
+    /**
+       View `this[start:stop:step]` without copying, where the bounds are
+       known at compile time.
+
+       @see slice
+    */
+    template<py::ssize_t start,
+             py::ssize_t stop = slice_end,
+             py::ssize_t step = 1>
+    item_span slice() const {
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return item_span();
+        }
+        return make_item_span<start, stop, step>(
+            reinterpret_cast<PyListObject*>(ob)->ob_item, PyList_GET_SIZE(ob));
+    }
+
+    /**
+       Copy `this[start:stop:step]` into a new list.
+
+       @see slice
+       @return A new list or nullptr.
+    */
+    tmpref<object> slice_copy(py::ssize_t start,
+                              py::ssize_t stop = slice_end,
+                              py::ssize_t step = 1) const;
+
+    /**
+       Get the object at a Python-style index known at compile time, with
+       bounds checking. Negative indices count from the end.
+
+       When the index is out of bounds this will return
+       `py::object(nullptr)` and set a Python `IndexError`.
+
+       @return A borrowed reference to the object at index `ix`.
+    */
+    template<py::ssize_t ix>
+    py::object at() const {
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return nullptr;
+        }
+        py::ssize_t normalized = normalize_index<ix>(PyList_GET_SIZE(ob));
+        if (normalized < 0) {
+            PyErr_SetString(PyExc_IndexError, "list index out of range");
+            return nullptr;
+        }
+        return PyList_GET_ITEM(ob, normalized);
+    }
+
     /**
        Coerce to a `nonnull` object.
 
@@ -245,30 +433,53 @@ inline int checkexact(const nonnull<object>&) {
     return 1;
 }
 
+/**
+   Create a new list from a Python iterable.
+
+   This is the implementation of `from_iterable` for `py::object`s.
+
+   @param seq The iterable to create a list from.
+   @return A new list or nullptr.
+*/
+tmpref<object> _from_py_iterable(const py::object &seq);
+
 /**
    Create a new list from another iterable object.
 
+   Exact `list` and `tuple` inputs are copied with a single pass over their
+   storage. Other Python iterables do not need to be sized: the result is
+   preallocated from `lenhint()` and grows as needed.
+   C++ ranges of `py::object` must provide `size()`.
+
    @param seq The sequence to create a list from.
-   @return A new tuple or nullptr.
+   @return A new list or nullptr.
 */
 template<typename T>
-tmpref<object> from_iterable(T seq) {
+tmpref<object> from_iterable(const T &seq) {
     if (!pyutils::is_nonnull(seq)) {
         pyutils::failed_null_check();
         return nullptr;
     }
 
-    tmpref<object> ob(seq.size());
-    ssize_t n = 0;
-
-    for (auto elem : seq) {
-        if (!elem.is_nonnull()) {
+    if constexpr (std::is_base_of<py::object, T>::value) {
+        return list::_from_py_iterable(seq);
+    }
+    else {
+        tmpref<object> ob(static_cast<py::ssize_t>(seq.size()));
+        if (!ob.is_nonnull()) {
             return nullptr;
         }
-        ob.setitem(n++, elem.incref());
-    }
 
-    return ob;
+        py::ssize_t n = 0;
+        for (const py::object &elem : seq) {
+            if (!elem.is_nonnull()) {
+                pyutils::failed_null_check();
+                return nullptr;
+            }
+            ob.setitem(n++, elem.incref());
+        }
+        return ob;
+    }
 }
 }
 
@@ -339,26 +550,328 @@ public:
 };
 
 namespace list {
+/**
+   Lists with at least this many elements are sorted on multiple threads by
+   `sort_native_parallel`.
+*/
+constexpr py::ssize_t parallel_sort_threshold = 1 << 16;
+
+/**
+   Sort a list in place without calling back into Python.
+
+   When every element is an exact `float`, an exact `int` which fits in 64
+   bits, or an exact `str`, the elements are sorted by their unboxed values
+   with a stable sort and then permuted in place. Large lists of `int`s use
+   a radix sort. The result is the same as `l.sort()`.
+
+   Any other list, including one holding a `nan`, is sorted with
+   `list.sort`.
+
+   @param l The list to sort.
+   @return -1 on failure, otherwise zero.
+*/
+int sort_native(const list::object &l);
+
+/**
+   Sort a list in place like `sort_native`, splitting the work across
+   threads when the list has at least `parallel_sort_threshold` elements.
+
+   The GIL is held for the duration of the sort.
+
+   @param l        The list to sort.
+   @param nthreads The number of threads to use, or 0 to use
+                   `std::thread::hardware_concurrency()`.
+   @return -1 on failure, otherwise zero.
+*/
+int sort_native_parallel(const list::object &l, unsigned nthreads = 0);
+
+/**
+   Create a new list by boxing each element of a contiguous C++ array.
+
+   The list is allocated once and filled in a single pass. Repeated values
+   share a boxed object and small integers come from the interpreter's
+   cache; see `py::box_range`.
+
+   @param data The values to box.
+   @param len  The number of values in `data`.
+   @return A new list or nullptr.
+*/
+template<typename T>
+tmpref<object> from_range(const T *data, py::ssize_t len) {
+    tmpref<object> ob(len);
+    if (!ob.is_nonnull()) {
+        return nullptr;
+    }
+    PyObject **items = reinterpret_cast<PyListObject*>(
+        static_cast<PyObject*>(ob))->ob_item;
+    if (py::box_range(items, data, len)) {
+        return nullptr;
+    }
+    return ob;
+}
+
+/**
+   Create a new list by boxing each element of a contiguous C++ range, for
+   example a `std::vector` or `std::array`.
+
+   @param range The values to box.
+   @return A new list or nullptr.
+*/
+template<typename R,
+         typename = decltype(std::data(std::declval<const R&>()))>
+tmpref<object> from_range(const R &range) {
+    return list::from_range(std::data(range),
+                            static_cast<py::ssize_t>(std::size(range)));
+}
+
+/**
+   A list of exact `float`s or `int`s paired with an unboxed copy of its
+   values.
+
+   The unboxed values are kept with a snapshot of the list's item pointers.
+   The snapshot holds a reference to each item, so an unchanged pointer
+   means an unchanged value, and `update()` only re-unboxes the list when
+   its size or any item pointer differs. Checking for changes is a single
+   `memcmp` of the item storage.
+
+   Like `buffer_view`, `is_nonnull()` reports if the proxy is valid.
+*/
+template<typename T>
+class of {
+private:
+    static_assert(std::is_arithmetic<T>::value &&
+                  !std::is_same<T, bool>::value,
+                  "list::of requires a numeric element type");
+
+    PyObject *ob;
+    PyObject *snapshot;
+    std::vector<T> unboxed;
+
+    static inline PyTypeObject *item_type() {
+        return std::is_floating_point<T>::value ? &PyFloat_Type : &PyLong_Type;
+    }
+
+    void clear() {
+        Py_CLEAR(ob);
+        Py_CLEAR(snapshot);
+        unboxed.clear();
+    }
+
+    int refresh() {
+        Py_CLEAR(snapshot);
+        PyObject *items = PyList_AsTuple(ob);
+        if (!items) {
+            clear();
+            return -1;
+        }
+
+        py::ssize_t len = PyTuple_GET_SIZE(items);
+        PyObject *const *item_array =
+            reinterpret_cast<PyTupleObject*>(items)->ob_item;
+        PyTypeObject *type = item_type();
+        for (py::ssize_t ix = 0; ix < len; ++ix) {
+            if (Py_TYPE(item_array[ix]) != type) {
+                PyErr_Format(PyExc_TypeError,
+                             "expected a list of %s, got %.200s at index %zd",
+                             type->tp_name,
+                             Py_TYPE(item_array[ix])->tp_name,
+                             ix);
+                Py_DECREF(items);
+                clear();
+                return -1;
+            }
+        }
+
+        unboxed.resize(len);
+        if (py::unbox_range(unboxed.data(), item_array, len)) {
+            Py_DECREF(items);
+            clear();
+            return -1;
+        }
+        snapshot = items;
+        return 0;
+    }
+
+public:
+    typedef T value_type;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+    typedef const_iterator iterator;
+
+    /**
+       Default constructor. The proxy will not hold a list.
+    */
+    of() : ob(nullptr), snapshot(nullptr) {}
+
+    /**
+       Validate and unbox a list. If `l` is not a list of `T`'s Python
+       type, the proxy will not hold a list and a Python exception will be
+       raised.
+
+       @param l The list to view.
+    */
+    explicit of(const py::object &l) : ob(nullptr), snapshot(nullptr) {
+        update(l);
+    }
+
+    of(const of&) = delete;
+    of &operator=(const of&) = delete;
+
+    of(of &&mvfrom) noexcept
+        : ob(mvfrom.ob),
+          snapshot(mvfrom.snapshot),
+          unboxed(std::move(mvfrom.unboxed)) {
+        mvfrom.ob = nullptr;
+        mvfrom.snapshot = nullptr;
+    }
+
+    of &operator=(of &&mvfrom) noexcept {
+        clear();
+        ob = mvfrom.ob;
+        snapshot = mvfrom.snapshot;
+        unboxed = std::move(mvfrom.unboxed);
+        mvfrom.ob = nullptr;
+        mvfrom.snapshot = nullptr;
+        return *this;
+    }
+
+    ~of() {
+        Py_XDECREF(ob);
+        Py_XDECREF(snapshot);
+    }
+
+    /**
+       Check if the proxy holds a list.
+    */
+    inline bool is_nonnull() const {
+        return snapshot;
+    }
+
+    /**
+       The list being viewed.
+    */
+    inline py::object list() const {
+        return ob;
+    }
+
+    /**
+       Check if the list has been mutated since it was last unboxed.
+
+       @return true if the list's size or any item differs from the
+               snapshot.
+    */
+    bool changed() const {
+        if (!is_nonnull()) {
+            return true;
+        }
+        py::ssize_t len = PyTuple_GET_SIZE(snapshot);
+        if (PyList_GET_SIZE(ob) != len) {
+            return true;
+        }
+        if (!len) {
+            return false;
+        }
+        return std::memcmp(reinterpret_cast<PyListObject*>(ob)->ob_item,
+                           reinterpret_cast<PyTupleObject*>(snapshot)->ob_item,
+                           len * sizeof(PyObject*));
+    }
+
+    /**
+       Re-unbox the list if it has been mutated.
+
+       @return zero on success, non-zero on failure. On failure the proxy
+               no longer holds a list.
+    */
+    int update() {
+        if (!ob) {
+            pyutils::failed_null_check();
+            return -1;
+        }
+        if (!changed()) {
+            return 0;
+        }
+        return refresh();
+    }
+
+    /**
+       View a new list, or re-unbox the current list if `l` is the list
+       already being viewed and it has been mutated.
+
+       @param l The list to view.
+       @return zero on success, non-zero on failure. On failure the proxy
+               no longer holds a list.
+    */
+    int update(const py::object &l) {
+        if (!l.is_nonnull()) {
+            clear();
+            pyutils::failed_null_check();
+            return -1;
+        }
+        if (static_cast<PyObject*>(l) != ob) {
+            if (!PyList_Check(l)) {
+                clear();
+                PyErr_Format(PyExc_TypeError,
+                             "expected a list, got %.200s",
+                             Py_TYPE(static_cast<PyObject*>(l))->tp_name);
+                return -1;
+            }
+            clear();
+            ob = l.incref();
+        }
+        return update();
+    }
+
+    /**
+       The unboxed values as of the last update.
+    */
+    inline const std::vector<T> &values() const {
+        return unboxed;
+    }
+
+    inline const T *data() const {
+        return unboxed.data();
+    }
+
+    inline py::ssize_t size() const {
+        return unboxed.size();
+    }
+
+    inline const T &operator[](py::ssize_t ix) const {
+        return unboxed[ix];
+    }
+
+    inline const_iterator begin() const {
+        return unboxed.begin();
+    }
+
+    inline const_iterator end() const {
+        return unboxed.end();
+    }
+};
+
 /**
    Pack variadic arguments into a Python `list` object.
 
+   The list is filled directly, one store per element. `tmpref` arguments
+   passed as rvalues have their reference stolen.
+
    @param elems The elements to pack.
    @return      The elements packed as a Python `list`.
 */
 template<typename... Ts>
-tmpref<object> pack(const Ts&... elems) {
-    object l(sizeof...(elems));
-
-    if (!l.is_nonnull()) {
+tmpref<object> pack(Ts&&... elems) {
+    if (!pyutils::all_nonnull(elems...)) {
+        pyutils::failed_null_check();
         return nullptr;
     }
 
-    py::nonnull<object> m = l.as_nonnull();
-    std::size_t n = 0;
-    for (const py::object &elem : { elems... }) {
-        m[n++] = elem;
+    PyObject *out = PyList_New(sizeof...(Ts));
+    if (!out) {
+        return nullptr;
     }
-    return std::move(l);
+    detail::_fill_items(reinterpret_cast<PyListObject*>(out)->ob_item,
+                        std::index_sequence_for<Ts...>{},
+                        std::forward<Ts>(elems)...);
+    return out;
 }
 }
 }
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <limits>
 #include <type_traits>
 
+#include <libpy/box.h>
 #include <libpy/object.h>
 #include <libpy/type.h>
 
@@ -31,6 +35,89 @@ namespace {
         std::is_base_of<object, O>::value,
         O,
         py::object>::type;
+
+    /**
+       Check if a value read with `py::read_small_int` can be returned as a
+       `T` without going through the C API.
+    */
+    template<typename T>
+    inline bool small_fits(long long value) {
+        if constexpr (std::is_floating_point<T>::value) {
+            return true;
+        }
+        else if constexpr (std::is_unsigned<T>::value) {
+            return value >= 0 &&
+                static_cast<unsigned long long>(value) <=
+                std::numeric_limits<T>::max();
+        }
+        else {
+            return value >= std::numeric_limits<T>::min() &&
+                value <= std::numeric_limits<T>::max();
+        }
+    }
+
+    /* Machine word implementations of the binary operators for operands
+       read with `py::read_small_int`. Each returns false when the result
+       does not fit in a `long long` or when Python would raise, leaving
+       the operation to the number protocol.
+    */
+
+    inline bool small_add(long long a, long long b, long long &out) {
+        return !__builtin_add_overflow(a, b, &out);
+    }
+
+    inline bool small_sub(long long a, long long b, long long &out) {
+        return !__builtin_sub_overflow(a, b, &out);
+    }
+
+    inline bool small_mul(long long a, long long b, long long &out) {
+        return !__builtin_mul_overflow(a, b, &out);
+    }
+
+    inline bool small_rem(long long a, long long b, long long &out) {
+        if (!b) {
+            return false;
+        }
+        // Python's `%` takes the sign of the divisor
+        out = a % b;
+        if (out && (out < 0) != (b < 0)) {
+            out += b;
+        }
+        return true;
+    }
+
+    inline bool small_lshift(long long a, long long b, long long &out) {
+        if (b < 0 || b >= std::numeric_limits<long long>::digits) {
+            return false;
+        }
+        out = static_cast<long long>(static_cast<unsigned long long>(a) << b);
+        return (out >> b) == a;
+    }
+
+    inline bool small_rshift(long long a, long long b, long long &out) {
+        if (b < 0) {
+            return false;
+        }
+        // `>>` on a negative value rounds toward negative infinity
+        constexpr long long max_shift = std::numeric_limits<long long>::digits;
+        out = a >> std::min(b, max_shift);
+        return true;
+    }
+
+    inline bool small_and(long long a, long long b, long long &out) {
+        out = a & b;
+        return true;
+    }
+
+    inline bool small_xor(long long a, long long b, long long &out) {
+        out = a ^ b;
+        return true;
+    }
+
+    inline bool small_or(long long a, long long b, long long &out) {
+        out = a | b;
+        return true;
+    }
 }
 
 class object : public py::object {
@@ -41,12 +128,21 @@ private:
     */
     void long_check();
 
+    /**
+       Convert to `T`, reading small values directly from the digits and
+       only calling `func` for values which do not fit in two digits or in
+       `T`, where `func` raises the appropriate error.
+    */
     template<typename T, T func(PyObject*)>
     inline T as_t() const {
         if (!is_nonnull()) {
             pyutils::failed_null_check();
             return -1;
         }
+        long long value;
+        if (read_small_int(ob, value) && small_fits<T>(value)) {
+            return static_cast<T>(value);
+        }
         return func(ob);
     }
 
@@ -56,8 +152,47 @@ private:
             pyutils::failed_null_check();
             return -1;
         }
+        long long value;
+        if (read_small_int(ob, value) && small_fits<T>(value)) {
+            overflow = 0;
+            return static_cast<T>(value);
+        }
         return func(ob, &overflow);
     }
+
+    /**
+       Read the value of `ob` if it is an exact `int` which fits in two
+       digits.
+    */
+    inline bool small_exact(long long &value) const {
+        return ob && PyLong_CheckExact(ob) && read_small_int(ob, value);
+    }
+
+    /**
+       Apply a binary operator, computing the result in a machine word with
+       `small` when both operands are exact `int`s which fit in two digits.
+       The result is boxed with `PyLong_FromLongLong` so small results come
+       from the small int cache. Anything else, including overflow, goes
+       through `func`.
+    */
+    template<PyObject *func(PyObject*, PyObject*),
+             bool small(long long, long long, long long&),
+             typename T>
+    inline PyObject *small_binary_func(const T &other) const {
+        if (!pyutils::all_nonnull(*this, other)) {
+            pyutils::failed_null_check();
+            return nullptr;
+        }
+        PyObject *rhs = other;
+        long long a;
+        long long b;
+        long long result;
+        if (small_exact(a) && PyLong_CheckExact(rhs) &&
+            read_small_int(rhs, b) && small(a, b, result)) {
+            return PyLong_FromLongLong(result);
+        }
+        return func(ob, rhs);
+    }
 public:
     friend tmpref<object>;
     friend const object &py::operator""_p(unsigned long long l);
@@ -113,22 +248,61 @@ public:
     unsigned long long as_unsigned_long_long() const;
     double as_double() const;
 
+#ifdef __SIZEOF_INT128__
+    /**
+       Convert to a 128 bit integer. Values which fit in two digits are read
+       directly; larger values are copied out of the digits with
+       `_PyLong_AsByteArray` without going through a string.
+
+       @return The value, or -1 with an `OverflowError` raised if it does
+               not fit.
+    */
+    __int128 as_int128() const;
+    unsigned __int128 as_uint128() const;
+#endif
+
+    /**
+       The number of bytes needed to hold the value. For negative powers of
+       two this may be one more than `to_bytes` needs.
+
+       @param is_signed Whether a sign bit is needed.
+       @return          The number of bytes, or -1 if an exception occured.
+    */
+    py::ssize_t byte_length(bool is_signed = true) const;
+
+    /**
+       Write the value into a byte buffer, like `int.to_bytes`.
+
+       @param out           The buffer to write into.
+       @param len           The size of `out`.
+       @param little_endian Whether the least significant byte comes first.
+       @param is_signed     Whether to use two's complement; if false,
+                            negative values raise an `OverflowError`.
+       @return              zero on success, non-zero on failure. Raises an
+                            `OverflowError` if the value does not fit in
+                            `len` bytes.
+    */
+    int to_bytes(unsigned char *out,
+                 std::size_t len,
+                 bool little_endian = PY_LITTLE_ENDIAN,
+                 bool is_signed = true) const;
+
     nonnull<object> as_nonnull() const;
     tmpref<object> as_tmpref() &&;
 
     template<typename T>
     tmpref<maybe_long_t<T>> operator+(const T &other) const {
-        return ob_binary_func<PyNumber_Add>(other);
+        return small_binary_func<PyNumber_Add, small_add>(other);
     }
 
     template<typename T>
     tmpref<maybe_long_t<T>> operator-(const T &other) const {
-        return ob_binary_func<PyNumber_Subtract>(other);
+        return small_binary_func<PyNumber_Subtract, small_sub>(other);
     }
 
     template<typename T>
     tmpref<maybe_long_t<T>> operator*(const T &other) const {
-        return ob_binary_func<PyNumber_Multiply>(other);
+        return small_binary_func<PyNumber_Multiply, small_mul>(other);
     }
 
 #if CPP_HAVE_MATMUL
@@ -142,7 +316,7 @@ public:
 
     template<typename T>
     tmpref<maybe_long_t<T>> operator%(const T &other) const {
-        return ob_binary_func<PyNumber_Remainder>(other);
+        return small_binary_func<PyNumber_Remainder, small_rem>(other);
     }
 
     template<typename T>
@@ -166,30 +340,54 @@ public:
 
     template<typename T>
     tmpref<maybe_long_t<T>> operator<<(const T &other) const {
-        return ob_binary_func<PyNumber_Lshift>(other);
+        return small_binary_func<PyNumber_Lshift, small_lshift>(other);
     }
 
     template<typename T>
     tmpref<maybe_long_t<T>> operator>>(const T &other) const {
-        return ob_binary_func<PyNumber_Rshift>(other);
+        return small_binary_func<PyNumber_Rshift, small_rshift>(other);
     }
 
     template<typename T>
     tmpref<maybe_long_t<T>> operator&(const T &other) const {
-        return ob_binary_func<PyNumber_And>(other);
+        return small_binary_func<PyNumber_And, small_and>(other);
     }
 
     template<typename T>
     tmpref<maybe_long_t<T>> operator^(const T &other) const {
-        return ob_binary_func<PyNumber_Xor>(other);
+        return small_binary_func<PyNumber_Xor, small_xor>(other);
     }
 
     template<typename T>
     tmpref<maybe_long_t<T>> operator|(const T &other) const {
-        return ob_binary_func<PyNumber_Or>(other);
+        return small_binary_func<PyNumber_Or, small_or>(other);
     }
 };
 
+#ifdef __SIZEOF_INT128__
+/**
+   Create an `int` from a 128 bit integer without losing precision.
+
+   @return A new `int` or nullptr.
+*/
+tmpref<object> from_int128(__int128 value);
+tmpref<object> from_uint128(unsigned __int128 value);
+#endif
+
+/**
+   Create an `int` from a byte buffer, like `int.from_bytes`.
+
+   @param data          The bytes to read.
+   @param len           The number of bytes in `data`.
+   @param little_endian Whether the least significant byte comes first.
+   @param is_signed     Whether the bytes are in two's complement.
+   @return              A new `int` or nullptr.
+*/
+tmpref<object> from_bytes(const unsigned char *data,
+                          std::size_t len,
+                          bool little_endian = PY_LITTLE_ENDIAN,
+                          bool is_signed = true);
+
 /**
    The type of Python `long` objects.
 
@@ -1,6 +1,8 @@
 #pragma once
+#include <iterator>
 #include <ostream>
 #include <type_traits>
+#include <utility>
 
 #include <Python.h>
 
@@ -33,6 +35,9 @@ constexpr int PRINT_RAW = Py_PRINT_RAW;
 
 class object;
 
+template<typename Policy>
+struct ops;
+
 // global singletons
 
 /**
@@ -271,13 +276,188 @@ protected:
         return func(ob, other.ob);
     }
 
+    /**
+       Adjust a negative index by the length of a sequence. Unlike
+       `PySequence_GetItem`, an index which is still negative raises an
+       `IndexError` instead of being passed to the type, which may wrap it
+       again.
+
+       @return zero on success, non-zero if an exception occured.
+    */
+    inline int sequence_index(PySequenceMethods *sq, py::ssize_t &ix) const {
+        if (ix >= 0 || !sq->sq_length) {
+            return 0;
+        }
+        py::ssize_t len = sq->sq_length(ob);
+        if (len < 0) {
+            return -1;
+        }
+        ix += len;
+        if (ix < 0) {
+            PyErr_Format(PyExc_IndexError,
+                         "%s index out of range",
+                         Py_TYPE(ob)->tp_name);
+            return -1;
+        }
+        return 0;
+    }
+
+    /**
+       `getitem_index` without the null check on `ob`.
+    */
+    inline tmpref<object> _getitem_index(py::ssize_t ix) const {
+        if (PyList_CheckExact(ob) || PyTuple_CheckExact(ob)) {
+            py::ssize_t len = PySequence_Fast_GET_SIZE(ob);
+            py::ssize_t normalized = ix < 0 ? ix + len : ix;
+            if (static_cast<std::size_t>(normalized) <
+                static_cast<std::size_t>(len)) {
+                PyObject *item = PySequence_Fast_GET_ITEM(ob, normalized);
+                Py_INCREF(item);
+                return item;
+            }
+            PyErr_Format(PyExc_IndexError,
+                         "%s index out of range",
+                         Py_TYPE(ob)->tp_name);
+            return nullptr;
+        }
+
+        PyMappingMethods *mp = Py_TYPE(ob)->tp_as_mapping;
+        PySequenceMethods *sq = Py_TYPE(ob)->tp_as_sequence;
+        if (!(mp && mp->mp_subscript) && sq && sq->sq_item) {
+            if (sequence_index(sq, ix)) {
+                return nullptr;
+            }
+            return sq->sq_item(ob, ix);
+        }
+        PyObject *key = PyLong_FromSsize_t(ix);
+        if (!key) {
+            return nullptr;
+        }
+        PyObject *out = PyObject_GetItem(ob, key);
+        Py_DECREF(key);
+        return out;
+    }
+
+    /**
+       `setitem_index` without the null check on `ob`.
+    */
+    inline int _setitem_index(py::ssize_t ix, const object &value) const {
+        if (value.ob && PyList_CheckExact(ob)) {
+            py::ssize_t len = PyList_GET_SIZE(ob);
+            py::ssize_t normalized = ix < 0 ? ix + len : ix;
+            if (static_cast<std::size_t>(normalized) <
+                static_cast<std::size_t>(len)) {
+                PyObject *old = PyList_GET_ITEM(ob, normalized);
+                Py_INCREF(value.ob);
+                PyList_SET_ITEM(ob, normalized, value.ob);
+                Py_DECREF(old);
+                return 0;
+            }
+        }
+
+        PyMappingMethods *mp = Py_TYPE(ob)->tp_as_mapping;
+        PySequenceMethods *sq = Py_TYPE(ob)->tp_as_sequence;
+        if (!(mp && mp->mp_ass_subscript) && sq && sq->sq_ass_item) {
+            if (sequence_index(sq, ix)) {
+                return -1;
+            }
+            return sq->sq_ass_item(ob, ix, value.ob);
+        }
+        PyObject *key = PyLong_FromSsize_t(ix);
+        if (!key) {
+            return -1;
+        }
+        int status = value.ob ?
+            PyObject_SetItem(ob, key, value.ob) :
+            PyObject_DelItem(ob, key);
+        Py_DECREF(key);
+        return status;
+    }
+
+    /**
+       Check if an integral key fits in a `py::ssize_t`. Unsigned keys above
+       `PY_SSIZE_T_MAX` would otherwise wrap around to a negative index.
+    */
+    template<typename T>
+    static constexpr bool _fits_index(T key) {
+        if constexpr (std::is_unsigned<T>::value) {
+            return key <= static_cast<std::make_unsigned_t<py::ssize_t>>(
+                PY_SSIZE_T_MAX);
+        }
+        else if constexpr (sizeof(T) > sizeof(py::ssize_t)) {
+            return key >= PY_SSIZE_T_MIN && key <= PY_SSIZE_T_MAX;
+        }
+        else {
+            return true;
+        }
+    }
+
+    /**
+       Box an integral key which does not fit in a `py::ssize_t`.
+    */
+    template<typename T>
+    static inline PyObject *_box_wide_index(T key) {
+        if constexpr (sizeof(T) > sizeof(long long)) {
+            return _PyLong_FromByteArray(
+                reinterpret_cast<const unsigned char*>(&key),
+                sizeof(T),
+                PY_LITTLE_ENDIAN,
+                std::is_signed<T>::value);
+        }
+        else if constexpr (std::is_unsigned<T>::value) {
+            return PyLong_FromUnsignedLongLong(key);
+        }
+        else {
+            return PyLong_FromLongLong(key);
+        }
+    }
+
+    /**
+       `_getitem_index` for any integral key. Keys which do not fit in a
+       `py::ssize_t` are boxed and passed to `PyObject_GetItem`.
+    */
+    template<typename T>
+    inline tmpref<object> _getitem_integral(T key) const {
+        if (_fits_index(key)) {
+            return _getitem_index(static_cast<py::ssize_t>(key));
+        }
+        PyObject *boxed = _box_wide_index(key);
+        if (!boxed) {
+            return nullptr;
+        }
+        PyObject *out = PyObject_GetItem(ob, boxed);
+        Py_DECREF(boxed);
+        return out;
+    }
+
+    /**
+       `_setitem_index` for any integral key. Keys which do not fit in a
+       `py::ssize_t` are boxed and passed to `PyObject_SetItem`.
+    */
+    template<typename T>
+    inline int _setitem_integral(T key, const object &value) const {
+        if (_fits_index(key)) {
+            return _setitem_index(static_cast<py::ssize_t>(key), value);
+        }
+        PyObject *boxed = _box_wide_index(key);
+        if (!boxed) {
+            return -1;
+        }
+        int status = value.ob ?
+            PyObject_SetItem(ob, boxed, value.ob) :
+            PyObject_DelItem(ob, boxed);
+        Py_DECREF(boxed);
+        return status;
+    }
+
 public:
     friend const object &operator""_p(char c);
     friend const object &operator""_p(const char *cs, std::size_t len);
     friend const object &operator""_p(wchar_t c);
     friend const object &operator""_p(const wchar_t *cs, std::size_t len);
-    friend const object &operator""_p(long double d);
     friend tmpref<object>;
+    template<typename Policy>
+    friend struct ops;
 
     /**
        Default constructor. The underyling pointer will be nullptr.
@@ -718,18 +898,62 @@ public:
     }
 
     // indexing
+    /**
+       Lookup an item by integer index without boxing the index.
+
+       Exact `list`s and `tuple`s are indexed directly. Like
+       `PyObject_GetItem`, types with a mapping `mp_subscript` slot, like
+       `dict`, are given the boxed index so that negative keys are not
+       rewritten. Other sequences go through their `sq_item` slot, where
+       negative indices count from the end like in Python.
+
+       @param ix The index to lookup.
+       @return   The value at the given index.
+    */
+    inline tmpref<object> getitem_index(py::ssize_t ix) const {
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return nullptr;
+        }
+
+        return _getitem_index(ix);
+    }
+
+    /**
+       Set or delete an item by integer index without boxing the index.
+
+       Exact `list`s are written directly. Like `PyObject_SetItem`, types
+       with a mapping `mp_ass_subscript` slot are given the boxed index.
+       Other sequences go through their `sq_ass_item` slot, where negative
+       indices count from the end like in Python.
+
+       @param ix    The index to set.
+       @param value The value to set, or `nullptr` to delete the item.
+       @return      zero on success, non-zero if an exception occured.
+    */
+    inline int setitem_index(py::ssize_t ix, const object &value) const {
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return -1;
+        }
+
+        return _setitem_index(ix, value);
+    }
+
     /**
        Lookup an item in a collection.
 
        This is equivalent to: `this.getitem(key)`.
        This does not support setitem syntax like: `this[key] = value`.
 
+       Integral keys use `getitem_index` and are not boxed.
+
        @param key The key to lookup.
        @return    The value for the given key.
     */
     template<typename T>
     tmpref<object> operator[](const T &key) const {
-        return ob_binary_func<PyObject_GetItem>(key);
+        return getitem(key);
     }
 
     /**
@@ -737,12 +961,24 @@ public:
 
        This is equivalent to: `this[key]`.
 
+       Integral keys use `getitem_index` and are not boxed, unless they do
+       not fit in a `py::ssize_t`.
+
        @param key The key to lookup.
        @return    The value for the given key.
     */
     template<typename T>
     tmpref<object> getitem(const T &key) const {
-        return ob_binary_func<PyObject_GetItem>(key);
+        if constexpr (std::is_integral<T>::value) {
+            if (!is_nonnull()) {
+                pyutils::failed_null_check();
+                return nullptr;
+            }
+            return _getitem_integral(key);
+        }
+        else {
+            return ob_binary_func<PyObject_GetItem>(key);
+        }
     }
 
     /**
@@ -750,18 +986,30 @@ public:
 
        This is equivalent to: `this[key] = value`.
 
+       Integral keys use `setitem_index` and are not boxed, unless they do
+       not fit in a `py::ssize_t`.
+
        @param key   The key to set.
        @param value The value to set.
        @return      zero on success, non-zero if an exception occured.
     */
     template<typename T>
     int setitem(const T &key, const object &value) const {
-        // value.ob can be nullptr for delitem
-        if (!pyutils::all_nonnull(*this, key)) {
-            pyutils::failed_null_check();
-            return -1;
+        if constexpr (std::is_integral<T>::value) {
+            if (!is_nonnull()) {
+                pyutils::failed_null_check();
+                return -1;
+            }
+            return _setitem_integral(key, value);
+        }
+        else {
+            // value.ob can be nullptr for delitem
+            if (!pyutils::all_nonnull(*this, key)) {
+                pyutils::failed_null_check();
+                return -1;
+            }
+            return PyObject_SetItem(ob, key.ob, value.ob);
         }
-        return PyObject_SetItem(ob, key.ob, value.ob);
     }
 
     /**
@@ -880,6 +1128,43 @@ public:
     tmpref<object> as_tmpref() &&;
 };
 
+namespace detail {
+template<typename T>
+struct _is_tmpref : std::false_type {};
+
+template<typename T>
+struct _is_tmpref<tmpref<T>> : std::true_type {};
+
+/**
+   Get a new reference to `elem` to store in a container. A `tmpref`
+   passed as an rvalue gives up its reference instead of being increfed.
+*/
+template<typename T>
+inline PyObject *_new_reference(T &&elem) {
+    PyObject *ob = static_cast<PyObject*>(elem);
+    if constexpr (_is_tmpref<std::decay_t<T>>::value &&
+                  !std::is_lvalue_reference<T>::value) {
+        std::move(elem).invalidate();
+    }
+    else {
+        Py_INCREF(ob);
+    }
+    return ob;
+}
+
+/**
+   Fill the item storage of a new `tuple` or `list` with new references to
+   `elems`. This expands to one store per element.
+*/
+template<std::size_t... ixs, typename... Ts>
+inline void _fill_items(PyObject **items,
+                        std::index_sequence<ixs...>,
+                        Ts&&... elems) {
+    (void) items;
+    ((items[ixs] = _new_reference(std::forward<Ts>(elems))), ...);
+}
+}
+
 namespace _tuple_templates{
 #include "libpy/_tuple_templates.h"
 }
@@ -901,8 +1186,7 @@ tmpref<object> object::operator()(const Ts&... args) const {
 
 namespace iter {
 template<typename T>
-class iterator :
-    public std::iterator<std::input_iterator_tag, T, void> {
+class iterator {
 private:
     ownedref<object> it;
     tmpref<object> last;
@@ -918,6 +1202,12 @@ protected:
 public:
     friend T;
 
+    typedef std::input_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef void difference_type;
+    typedef T *pointer;
+    typedef T &reference;
+
     /**
        Default constructor for cend.
     */
@@ -994,11 +1284,6 @@ const object &operator""_p(wchar_t c);
 */
 const object &operator""_p(const wchar_t *cs, std::size_t len);
 
-/**
-   Operator overload for float objects.
-*/
-const object &operator""_p(long double d);
-
 /**
    ostream writing for objects.
 
@@ -1032,3 +1317,7 @@ bool is_nonnull(const T &t) {
     return _is_nonnull<T, std::is_base_of<py::object, T>::value>::f(t);
 }
 }
+
+// The float literal, `1.5_p`, is defined with `py::float_::object`. It is
+// included last so that `float.h` sees the complete `py::object`.
+#include "libpy/float.h"
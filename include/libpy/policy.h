@@ -0,0 +1,256 @@
+#pragma once
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#include "libpy/object.h"
+#include "libpy/utils.h"
+
+namespace py {
+/**
+   A C++ exception which carries a raised Python exception.
+
+   Constructing an `error_already_set` takes the active Python exception
+   out of the interpreter so that code which runs while the C++ exception
+   unwinds sees a clean error state. `restore()` raises it again; this is
+   how `automethod` hands it back to Python.
+*/
+class error_already_set : public std::exception {
+private:
+    PyObject *type;
+    PyObject *value;
+    PyObject *tb;
+
+public:
+    /**
+       Take the active Python exception. If no exception is active, a
+       `SystemError` is used instead so that `restore()` always raises.
+    */
+    error_already_set();
+
+    error_already_set(const error_already_set &cpfrom);
+    error_already_set(error_already_set &&mvfrom) noexcept;
+
+    error_already_set &operator=(const error_already_set&) = delete;
+
+    ~error_already_set();
+
+    /**
+       Raise the Python exception again. After this the object no longer
+       holds the exception.
+    */
+    void restore();
+
+    /**
+       Check if the exception is an instance of `exc`.
+
+       @param exc An exception type or tuple of exception types.
+       @return    Whether the exception matches.
+    */
+    bool matches(const py::object &exc) const;
+
+    const char *what() const noexcept override;
+};
+
+/**
+   Error handling policies for `py::check` and `py::ops`.
+
+   Each policy provides:
+
+   ```
+   static constexpr bool check_inputs;
+   static constexpr bool check_results;
+   template<typename T> static T failed(T &&result);
+   ```
+
+   `check_inputs` controls the null checks on operands and `check_results`
+   controls if results are tested for failure. `failed` is called with a
+   failed result, which is a null object or -1, while a Python exception is
+   raised.
+*/
+namespace policy {
+/**
+   Failures return `nullptr` or -1 with a Python exception raised. This is
+   how every wrapper operation behaves.
+*/
+struct propagate {
+    static constexpr bool check_inputs = true;
+    static constexpr bool check_results = true;
+
+    template<typename T>
+    static inline T failed(T &&result) {
+        return std::forward<T>(result);
+    }
+};
+
+/**
+   Failures throw a `py::error_already_set`, so a successful result never
+   needs to be checked by the caller.
+*/
+struct throws {
+    static constexpr bool check_inputs = true;
+    static constexpr bool check_results = true;
+
+    template<typename T>
+    [[noreturn]] static inline T failed(T&&) {
+        throw error_already_set();
+    }
+};
+
+/**
+   Nothing is checked. Only use this where the operands are known to be
+   valid and the operations cannot fail.
+*/
+struct unchecked {
+    static constexpr bool check_inputs = false;
+    static constexpr bool check_results = false;
+
+    template<typename T>
+    static inline T failed(T &&result) {
+        return std::forward<T>(result);
+    }
+};
+}
+
+namespace detail {
+/**
+   Check if the result of a wrapper operation is a failure.
+*/
+template<typename T>
+inline bool _is_failure(const T &result) {
+    if constexpr (std::is_base_of<py::object, T>::value) {
+        return !result.is_nonnull();
+    }
+    else if constexpr (std::is_pointer<T>::value) {
+        return !result;
+    }
+    else {
+        static_assert(std::is_integral<T>::value,
+                      "results must be objects, pointers, or integers");
+        return result == -1 && PyErr_Occurred();
+    }
+}
+}
+
+/**
+   Apply an error handling policy to the result of an operation.
+
+   ```
+   auto x = py::check<py::policy::throws>(ob.getattr("x"_p));
+   ```
+
+   @param result The result of an operation which returns a null object or
+                 -1 on failure.
+   @return       `result`. With `policy::throws`, failures throw instead of
+                 returning.
+*/
+template<typename Policy, typename T>
+inline std::decay_t<T> check(T &&result) {
+    if constexpr (Policy::check_results) {
+        if (detail::_is_failure(result)) {
+            return Policy::failed(std::forward<T>(result));
+        }
+    }
+    return std::forward<T>(result);
+}
+
+/**
+   Common object operations with an error handling policy.
+
+   These call the C API directly instead of going through the `py::object`
+   members, so each operation checks its operands at most once and its
+   result at most once: `policy::propagate` and `policy::throws` do both,
+   and `policy::unchecked` does neither.
+*/
+template<typename Policy>
+struct ops {
+private:
+    /**
+       Null check the operands if the policy asks for it.
+
+       @return true if the operation may run, false with a Python exception
+               raised.
+    */
+    template<typename... Ts>
+    static inline bool inputs_ok(const Ts&... obs) {
+        if constexpr (Policy::check_inputs) {
+            if (!pyutils::all_nonnull(obs...)) {
+                pyutils::failed_null_check();
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    /**
+       This is equivalent to: `getattr(ob, attr)`.
+    */
+    static inline tmpref<object> getattr(const object &ob,
+                                         const object &attr) {
+        if (!inputs_ok(ob, attr)) {
+            return Policy::failed(tmpref<object>(nullptr));
+        }
+        return check<Policy>(tmpref<object>(PyObject_GetAttr(ob, attr)));
+    }
+
+    /**
+       This is equivalent to: `ob[key]`. Integral keys are not boxed.
+    */
+    template<typename T>
+    static inline tmpref<object> getitem(const object &ob, const T &key) {
+        if constexpr (std::is_integral<T>::value) {
+            if (!inputs_ok(ob)) {
+                return Policy::failed(tmpref<object>(nullptr));
+            }
+            return check<Policy>(ob._getitem_integral(key));
+        }
+        else {
+            if (!inputs_ok(ob, key)) {
+                return Policy::failed(tmpref<object>(nullptr));
+            }
+            return check<Policy>(tmpref<object>(PyObject_GetItem(ob, key)));
+        }
+    }
+
+    /**
+       This is equivalent to: `ob[key] = value`. If `value` is `nullptr`
+       the item is deleted.
+
+       @return zero on success, non-zero on failure.
+    */
+    template<typename T>
+    static inline int setitem(const object &ob,
+                              const T &key,
+                              const object &value) {
+        int status;
+        if constexpr (std::is_integral<T>::value) {
+            if (!inputs_ok(ob)) {
+                return Policy::failed(-1);
+            }
+            status = ob._setitem_integral(key, value);
+        }
+        else {
+            if (!inputs_ok(ob, key)) {
+                return Policy::failed(-1);
+            }
+            status = value.is_nonnull() ?
+                PyObject_SetItem(ob, key, value) :
+                PyObject_DelItem(ob, key);
+        }
+        return check<Policy>(status);
+    }
+
+    /**
+       This is equivalent to: `ob(*args)`.
+    */
+    template<typename... Ts>
+    static inline tmpref<object> call(const object &ob, const Ts&... args) {
+        if (!inputs_ok(ob, args...)) {
+            return Policy::failed(tmpref<object>(nullptr));
+        }
+        return check<Policy>(tmpref<object>(PyObject_CallFunctionObjArgs(
+            ob, static_cast<PyObject*>(args)..., nullptr)));
+    }
+};
+}
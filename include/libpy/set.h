@@ -0,0 +1,401 @@
+#pragma once
+#include <iterator>
+#include <type_traits>
+
+#include "libpy/hashed_key.h"
+#include "libpy/list.h"
+#include "libpy/object.h"
+#include "libpy/type.h"
+
+namespace py {
+namespace set {
+/**
+   A constant iterator over the members of a set or frozenset.
+
+   Sets store the hash of each member, so this yields `py::hashed_key`s
+   which can be used to look the members up in other containers without
+   rehashing them. The set must not be resized while it is being iterated.
+*/
+class const_iterator {
+private:
+    PyObject *ob;
+    py::ssize_t pos;
+    hashed_key item;
+
+    /**
+       Move to the next member of the set. When the set is exhausted `ob`
+       will be set to `nullptr` which makes this equal to the end marker.
+    */
+    inline void advance() {
+        PyObject *key;
+        hash_t hash;
+
+        if (ob && _PySet_NextEntry(ob, &pos, &key, &hash)) {
+            item = hashed_key(key, hash);
+        }
+        else {
+            ob = nullptr;
+            pos = 0;
+            item = hashed_key();
+        }
+    }
+
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef hashed_key value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type *pointer;
+    typedef const value_type &reference;
+
+    /**
+       Default constructor for cend.
+    */
+    const_iterator() : ob(nullptr), pos(0), item() {}
+
+    /**
+       Create an iterator at the start of a set.
+
+       @param ob The set to iterate over. This may be `nullptr` to create
+                 the end marker.
+    */
+    explicit const_iterator(PyObject *ob) : ob(ob), pos(0), item() {
+        advance();
+    }
+
+    bool operator==(const const_iterator &other) const {
+        return ob == other.ob && pos == other.pos;
+    }
+
+    bool operator!=(const const_iterator &other) const {
+        return !(*this == other);
+    }
+
+    reference operator*() const {
+        return item;
+    }
+
+    pointer operator->() const {
+        return &item;
+    }
+
+    const_iterator &operator++() {
+        advance();
+        return *this;
+    }
+
+    const_iterator operator++(int) {
+        const_iterator tmp = *this;
+        advance();
+        return tmp;
+    }
+};
+
+/**
+   A subclass of `py::object` for optional sets and frozensets.
+*/
+class object : public py::object {
+private:
+    /**
+       Function called to verify that `ob` is a set or frozenset and
+       correctly raise a python exception otherwies.
+    */
+    void set_check();
+public:
+    friend class py::tmpref<object>;
+
+    /**
+       Default constructor. This will set `ob` to nullptr.
+    */
+    object();
+
+    /**
+       Constructor from `PyObject*`. If `pob` is not a `set` or `frozenset`
+       then `ob` will be set to `nullptr`.
+    */
+    object(PyObject *pob);
+
+    /**
+       Constructor from `py::object`. If `pob` is not a `set` or
+       `frozenset` then `ob` will be set to `nullptr`.
+    */
+    object(const py::object &pob);
+
+    object(const object &cpfrom);
+    object(object &&mvfrom) noexcept;
+
+    using py::object::operator=;
+
+    /**
+       Iteration over a set yields `py::hashed_key`s which carry the hash
+       stored in the set.
+    */
+    typedef set::const_iterator const_iterator;
+    typedef const_iterator iterator;
+
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    iterator begin() const;
+    iterator end() const;
+
+    /**
+       Get the number of members of the set.
+
+       This is equivalent to `len(this)`.
+
+       @return The length of the object or -1 if an exception occured.
+    */
+    py::ssize_t len() const;
+
+    /**
+       Check if the set contains a key.
+
+       This is equivalent to: `key in this`.
+
+       CPython has no known-hash lookup for sets, so unlike `dict` there is
+       no `hashed_key` overload; the key is always hashed again.
+
+       @param key The key to look for.
+       @return    1 if `key` is in the set, 0 if `key` is not in the set,
+                  or -1 if an exception occured.
+    */
+    int contains(const py::object &key) const;
+
+    /**
+       Add a key to the set.
+
+       This is equivalent to: `this.add(key)`.
+       This may be used to fill a new `frozenset` before it is shared.
+
+       @param key The key to add.
+       @return    zero on success, non-zero if an exception occured.
+    */
+    int add(const py::object &key) const;
+
+    /**
+       Remove a key from the set if it is present.
+
+       This is equivalent to: `this.discard(key)`.
+
+       @param key The key to remove.
+       @return    1 if `key` was removed, 0 if `key` was not in the set,
+                  or -1 if an exception occured.
+    */
+    int discard(const py::object &key) const;
+
+    /**
+       Add all of the elements of a C++ range of objects to the set.
+
+       @param range The elements to add.
+       @return      zero on success, non-zero if an exception occured.
+    */
+    template<typename T>
+    int update(const T &range) const {
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return -1;
+        }
+        for (const py::object &elem : range) {
+            if (!elem.is_nonnull()) {
+                pyutils::failed_null_check();
+                return -1;
+            }
+            if (PySet_Add(ob, elem)) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+       Add all of the elements of a list to the set. This walks the list's
+       storage directly.
+
+       @param l The list of elements to add.
+       @return  zero on success, non-zero if an exception occured.
+    */
+    int update(const list::object &l) const;
+
+    /**
+       Coerce to a `nonnull` object.
+
+       @see nonnull
+       @throws pyutil::bad_nonnull Thrown when `ob == nullptr`.
+       @return this converted to a `nonnull` object.
+    */
+    nonnull<object> as_nonnull() const;
+
+    /**
+       Create a temporary reference. This is a reference that will
+       decref the object when it is destroyed.
+
+       @return this converted into a tmpref.
+    */
+    tmpref<object> as_tmpref() &&;
+};
+
+/**
+   The type of Python `set` objects.
+
+   This is equivalent to: `set`.
+*/
+extern const type::object<set::object> type;
+
+/**
+   The type of Python `frozenset` objects.
+
+   This is equivalent to: `frozenset`.
+*/
+extern const type::object<set::object> frozenset_type;
+
+/**
+   Check if an object is an instance of `set` or `frozenset`.
+
+   @param t The object to check
+   @return  1 if `ob` is an instance of `set` or `frozenset`, 0 if `ob` is
+            not an instance of `set` or `frozenset`, -1 if an exception
+            occured.
+*/
+template<typename T>
+inline int check(const T &t) {
+    if (!t.is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PyAnySet_Check(t);
+}
+
+inline int check(const nonnull<object>&) {
+    return 1;
+}
+
+/**
+   Check if an object is an instance of `set` or `frozenset` but not a
+   subclass.
+
+   @param t The object to check
+   @return  1 if `ob` is an instance of `set` or `frozenset`, 0 if `ob` is
+            not an instance of `set` or `frozenset`, -1 if an exception
+            occured.
+*/
+template<typename T>
+inline int checkexact(const T &t) {
+    if (!t.is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PyAnySet_CheckExact(t);
+}
+
+inline int checkexact(const nonnull<object>&) {
+    return 1;
+}
+
+namespace detail {
+/**
+   Fill a new set from a C++ range of objects.
+*/
+template<typename T>
+tmpref<object> _from_iterable(PyObject *(*make)(PyObject*),
+                              const T &seq,
+                              std::false_type) {
+    tmpref<object> ob(make(nullptr));
+    if (ob.update(seq)) {
+        return nullptr;
+    }
+    return ob;
+}
+
+/**
+   Fill a new set from a Python iterable. Exact lists are walked directly,
+   other iterables are handed to the set constructor which reuses the
+   hashes stored in sets and dicts.
+*/
+template<typename T>
+tmpref<object> _from_iterable(PyObject *(*make)(PyObject*),
+                              const T &seq,
+                              std::true_type) {
+    if (!seq.is_nonnull()) {
+        pyutils::failed_null_check();
+        return nullptr;
+    }
+    if (PyList_CheckExact(static_cast<PyObject*>(seq))) {
+        tmpref<object> ob(make(nullptr));
+        if (ob.update(list::object(seq))) {
+            return nullptr;
+        }
+        return ob;
+    }
+    return make(seq);
+}
+}
+
+/**
+   Create a new set from another iterable object.
+
+   @param seq The sequence to create a set from.
+   @return A new set or nullptr.
+*/
+template<typename T>
+tmpref<object> from_iterable(const T &seq) {
+    return detail::_from_iterable(PySet_New,
+                                  seq,
+                                  std::is_base_of<py::object, T>{});
+}
+
+/**
+   Create a new frozenset from another iterable object.
+
+   @param seq The sequence to create a frozenset from.
+   @return A new frozenset or nullptr.
+*/
+template<typename T>
+tmpref<object> frozenset_from_iterable(const T &seq) {
+    return detail::_from_iterable(PyFrozenSet_New,
+                                  seq,
+                                  std::is_base_of<py::object, T>{});
+}
+}
+
+/**
+   A `py::set::object` where `ob` is known to be nonnull.
+   This is used to skip null checks for performance.
+
+   This class should be used where users want to trade the ability to
+   write a nested expression for perfomance.
+*/
+template<>
+class nonnull<set::object> : public set::object {
+protected:
+    nonnull() = delete;
+    explicit nonnull(PyObject *ob) : set::object(ob) {}
+public:
+    friend class object;
+
+    nonnull(const nonnull &cpfrom) : set::object(cpfrom) {}
+    nonnull(nonnull &&mvfrom) noexcept : set::object(mvfrom.ob) {
+        mvfrom.ob = nullptr;
+    }
+
+    nonnull &operator=(const nonnull &cpfrom) {
+        nonnull<set::object> tmp(cpfrom);
+        return (*this = std::move(tmp));
+    }
+
+    nonnull &operator=(nonnull &&mvfrom) noexcept {
+        ob = mvfrom.ob;
+        mvfrom.ob = nullptr;
+        return *this;
+    }
+
+    /**
+       Get the number of members of the set.
+
+       This is equivalent to `len(this)`.
+
+       @return The length of the object.
+    */
+    py::ssize_t len() const {
+        return PySet_GET_SIZE(ob);
+    }
+};
+}
@@ -0,0 +1,290 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+#include "libpy/object.h"
+
+namespace py {
+/**
+   A stop bound which means "to the end of the sequence", like an omitted
+   stop in `seq[start:]`.
+*/
+constexpr py::ssize_t slice_end = PY_SSIZE_T_MAX;
+
+/**
+   A borrowed, non-owning view over a strided range of the items of a
+   `list` or `tuple`.
+
+   The view does not hold references to the items. It is valid for as long
+   as the sequence it came from is alive and, for a `list`, is not
+   resized.
+
+   Like `py::object`, `is_nonnull()` reports if the view is valid.
+*/
+class item_span {
+private:
+    PyObject *const *items;
+    py::ssize_t len;
+    py::ssize_t step;
+    bool valid;
+
+public:
+    /**
+       Iterator over the items of an `item_span`, following its step.
+
+       The position is kept as an index into the view rather than a
+       pointer, so the end of a view with a negative step does not point
+       before the first item.
+    */
+    class iterator {
+    private:
+        PyObject *const *items;
+        py::ssize_t ix;
+        py::ssize_t step;
+
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef py::object value_type;
+        typedef py::ssize_t difference_type;
+        typedef const py::object *pointer;
+        typedef py::object reference;
+
+        iterator(PyObject *const *items, py::ssize_t ix, py::ssize_t step)
+            : items(items), ix(ix), step(step) {}
+
+        inline py::object operator*() const {
+            return items[ix * step];
+        }
+
+        inline py::object operator[](py::ssize_t n) const {
+            return items[(ix + n) * step];
+        }
+
+        inline iterator &operator++() {
+            ++ix;
+            return *this;
+        }
+
+        inline iterator operator++(int) {
+            iterator out = *this;
+            ++ix;
+            return out;
+        }
+
+        inline iterator &operator--() {
+            --ix;
+            return *this;
+        }
+
+        inline iterator operator--(int) {
+            iterator out = *this;
+            --ix;
+            return out;
+        }
+
+        inline iterator &operator+=(py::ssize_t n) {
+            ix += n;
+            return *this;
+        }
+
+        inline iterator &operator-=(py::ssize_t n) {
+            ix -= n;
+            return *this;
+        }
+
+        inline iterator operator+(py::ssize_t n) const {
+            return iterator(items, ix + n, step);
+        }
+
+        friend inline iterator operator+(py::ssize_t n, const iterator &it) {
+            return it + n;
+        }
+
+        inline iterator operator-(py::ssize_t n) const {
+            return iterator(items, ix - n, step);
+        }
+
+        inline py::ssize_t operator-(const iterator &other) const {
+            return ix - other.ix;
+        }
+
+        inline bool operator==(const iterator &other) const {
+            return ix == other.ix;
+        }
+
+        inline bool operator!=(const iterator &other) const {
+            return ix != other.ix;
+        }
+
+        inline bool operator<(const iterator &other) const {
+            return ix < other.ix;
+        }
+
+        inline bool operator<=(const iterator &other) const {
+            return ix <= other.ix;
+        }
+
+        inline bool operator>(const iterator &other) const {
+            return ix > other.ix;
+        }
+
+        inline bool operator>=(const iterator &other) const {
+            return ix >= other.ix;
+        }
+    };
+
+    typedef iterator const_iterator;
+
+    /**
+       Default constructor. The view is not valid.
+    */
+    item_span() : items(nullptr), len(0), step(1), valid(false) {}
+
+    /**
+       Construct a view from a pointer to the first item, the number of
+       items, and the distance between items.
+    */
+    item_span(PyObject *const *items, py::ssize_t len, py::ssize_t step = 1)
+        : items(items), len(len), step(step), valid(true) {}
+
+    /**
+       Check if the view is valid.
+    */
+    inline bool is_nonnull() const {
+        return valid;
+    }
+
+    /**
+       The number of items in the view.
+    */
+    inline py::ssize_t size() const {
+        return len;
+    }
+
+    inline bool empty() const {
+        return !len;
+    }
+
+    /**
+       Get the item at `ix` without bounds checking.
+
+       @param ix The index into the view.
+       @return   A borrowed reference to the item.
+    */
+    inline py::object operator[](py::ssize_t ix) const {
+        return items[ix * step];
+    }
+
+    inline iterator begin() const {
+        return iterator(items, 0, step);
+    }
+
+    inline iterator end() const {
+        return iterator(items, len, step);
+    }
+
+    /**
+       Write new references to each item into `out`.
+
+       @param out Storage for `size()` objects.
+    */
+    inline void copy_to(PyObject **out) const {
+        if (step == 1) {
+            std::copy(items, items + len, out);
+        }
+        else {
+            for (py::ssize_t ix = 0; ix < len; ++ix) {
+                out[ix] = items[ix * step];
+            }
+        }
+        for (py::ssize_t ix = 0; ix < len; ++ix) {
+            Py_INCREF(out[ix]);
+        }
+    }
+
+    /**
+       Materialize the view as a new `tuple`.
+
+       @return A new tuple or nullptr.
+    */
+    tmpref<object> to_tuple() const;
+
+    /**
+       Materialize the view as a new `list`.
+
+       @return A new list or nullptr.
+    */
+    tmpref<object> to_list() const;
+};
+
+/**
+   Compute the items of `seq[start:stop:step]` for a sequence of length
+   `len`, following Python's rules for negative and out of range bounds.
+
+   @param items The items of the sequence.
+   @param len   The length of the sequence.
+   @param start The start bound.
+   @param stop  The stop bound, or `py::slice_end`.
+   @param step  The step, which may not be zero.
+   @return      The view. If `step` is zero the view is not valid and a
+                Python `ValueError` is raised.
+*/
+item_span make_item_span(PyObject *const *items,
+                         py::ssize_t len,
+                         py::ssize_t start,
+                         py::ssize_t stop,
+                         py::ssize_t step);
+
+/**
+   `make_item_span` where the bounds are known at compile time. For a
+   positive step, bounds which are not negative do not need to be adjusted
+   by the length of the sequence so only the clamping remains.
+*/
+template<py::ssize_t start, py::ssize_t stop, py::ssize_t step>
+inline item_span make_item_span(PyObject *const *items, py::ssize_t len) {
+    static_assert(step != 0, "slice step cannot be zero");
+
+    if constexpr (step < 0) {
+        return make_item_span(items, len, start, stop, step);
+    }
+    else {
+        py::ssize_t first;
+        if constexpr (start < 0) {
+            first = std::max<py::ssize_t>(start + len, 0);
+        }
+        else {
+            first = std::min<py::ssize_t>(start, len);
+        }
+
+        py::ssize_t last;
+        if constexpr (stop == slice_end) {
+            last = len;
+        }
+        else if constexpr (stop < 0) {
+            last = std::max<py::ssize_t>(stop + len, 0);
+        }
+        else {
+            last = std::min<py::ssize_t>(stop, len);
+        }
+
+        py::ssize_t count = last > first ? (last - first - 1) / step + 1 : 0;
+        return item_span(items + first, count, step);
+    }
+}
+
+/**
+   Normalize a Python-style index known at compile time against a length.
+
+   @return The non-negative index, or -1 if it is out of bounds.
+*/
+template<py::ssize_t ix>
+inline py::ssize_t normalize_index(py::ssize_t len) {
+    if constexpr (ix < 0) {
+        return (ix + len < 0) ? -1 : ix + len;
+    }
+    else {
+        return (ix < len) ? ix : -1;
+    }
+}
+}
@@ -0,0 +1,300 @@
+#pragma once
+#include <string_view>
+#include <tuple>
+
+#include "libpy/object.h"
+#include "libpy/type.h"
+
+namespace py {
+namespace str {
+/**
+   The width of the code units used to store a `str`.
+*/
+enum class kind {
+    ucs1 = PyUnicode_1BYTE_KIND,
+    ucs2 = PyUnicode_2BYTE_KIND,
+    ucs4 = PyUnicode_4BYTE_KIND,
+};
+
+/**
+   A non-owning view over the code units of a `str`.
+
+   `Char` is one of `Py_UCS1`, `Py_UCS2`, or `Py_UCS4` to match the kind of
+   the string. Each code unit is a full code point.
+*/
+template<typename Char>
+class kind_view {
+private:
+    const Char *ptr;
+    py::ssize_t len;
+
+public:
+    typedef Char value_type;
+    typedef const Char* const_iterator;
+    typedef const_iterator iterator;
+
+    kind_view() : ptr(nullptr), len(0) {}
+    kind_view(const Char *ptr, py::ssize_t len) : ptr(ptr), len(len) {}
+
+    inline const Char *data() const {
+        return ptr;
+    }
+
+    inline py::ssize_t size() const {
+        return len;
+    }
+
+    inline bool empty() const {
+        return !len;
+    }
+
+    inline Char operator[](py::ssize_t idx) const {
+        return ptr[idx];
+    }
+
+    inline const_iterator begin() const {
+        return ptr;
+    }
+
+    inline const_iterator end() const {
+        return ptr + len;
+    }
+};
+
+/**
+   A subclass of `py::object` for optional strs.
+*/
+class object : public py::object {
+private:
+    /**
+       Function called to verify that `ob` is a str and
+       correctly raise a python exception otherwies.
+    */
+    void str_check();
+
+    /**
+       Make sure the canonical representation of a legacy string has been
+       computed.
+
+       @return zero on success, non-zero on failure.
+    */
+    inline int ready() const {
+#if PY_VERSION_HEX < 0x030C0000
+        return PyUnicode_READY(ob);
+#else
+        return 0;
+#endif
+    }
+
+public:
+    friend class py::tmpref<object>;
+
+    /**
+       Default constructor. This will set `ob` to nullptr.
+    */
+    object();
+
+    /**
+       Constructor from `PyObject*`. If `pob` is not a `str` then
+       `ob` will be set to `nullptr`.
+    */
+    object(PyObject *pob);
+
+    /**
+       Constructor from `py::object`. If `pob` is not a `str` then
+       `ob` will be set to `nullptr`.
+    */
+    object(const py::object &pob);
+
+    /**
+       Constructor from UTF-8 encoded text. This allocates a new `str`.
+
+       This constructor is explicit because the user must manually
+       decref the object.
+
+       @param cs The text to decode.
+    */
+    explicit object(std::string_view cs);
+
+    object(const object &cpfrom);
+    object(object &&mvfrom) noexcept;
+
+    using py::object::operator=;
+
+    /**
+       Get the number of code points in the str.
+
+       This is equivalent to `len(this)`.
+
+       @return The length of the object or -1 if an exception occured.
+    */
+    py::ssize_t len() const;
+
+    /**
+       View the str as UTF-8 encoded text.
+
+       The UTF-8 representation is cached on the str so this only encodes
+       the first time it is called. For ASCII strings there is nothing to
+       encode. The view is valid for as long as the str is alive.
+
+       @return A view over the UTF-8 text. If the str cannot be encoded the
+               view's `data()` will be `nullptr` and a Python exception will
+               be raised.
+    */
+    std::string_view as_string_view() const;
+
+    /**
+       Get the width of the code units used to store the str.
+
+       @return The kind of the str.
+    */
+    str::kind kind() const;
+
+    /**
+       View the code units of the str without a copy.
+
+       `Char` must match `kind()`: `Py_UCS1` for `kind::ucs1`, `Py_UCS2` for
+       `kind::ucs2` and `Py_UCS4` for `kind::ucs4`.
+
+       @return A view over the code units of the str. If `Char` does not
+               match the kind of the str the view's `data()` will be
+               `nullptr` and a `TypeError` will be raised.
+    */
+    template<typename Char>
+    kind_view<Char> view() const {
+        static_assert(sizeof(Char) == PyUnicode_1BYTE_KIND ||
+                      sizeof(Char) == PyUnicode_2BYTE_KIND ||
+                      sizeof(Char) == PyUnicode_4BYTE_KIND,
+                      "Char must be Py_UCS1, Py_UCS2, or Py_UCS4");
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return {};
+        }
+        if (ready()) {
+            return {};
+        }
+        if (PyUnicode_KIND(ob) != sizeof(Char)) {
+            PyErr_Format(PyExc_TypeError,
+                         "cannot view a str of kind %d with %d byte code units",
+                         static_cast<int>(PyUnicode_KIND(ob)),
+                         static_cast<int>(sizeof(Char)));
+            return {};
+        }
+        return {static_cast<const Char*>(PyUnicode_DATA(ob)),
+                PyUnicode_GET_LENGTH(ob)};
+    }
+
+    /**
+       Call a function with a view of the code units of the str that is
+       specialized on the str's kind.
+
+       This lets scanning code dispatch on the kind once per string instead
+       of once per code point. `f` is called with one of
+       `kind_view<Py_UCS1>`, `kind_view<Py_UCS2>` or `kind_view<Py_UCS4>`
+       and must return the same type for each.
+
+       When `ob` is `nullptr`, `f` is called with an empty
+       `kind_view<Py_UCS1>` and a Python exception is raised.
+
+       @param f The function to call.
+       @return The result of `f`.
+    */
+    template<typename F>
+    decltype(auto) visit(F &&f) const {
+        if (!is_nonnull() || ready()) {
+            pyutils::failed_null_check();
+            return f(kind_view<Py_UCS1>());
+        }
+
+        py::ssize_t len = PyUnicode_GET_LENGTH(ob);
+        switch (PyUnicode_KIND(ob)) {
+        case PyUnicode_1BYTE_KIND:
+            return f(kind_view<Py_UCS1>(PyUnicode_1BYTE_DATA(ob), len));
+        case PyUnicode_2BYTE_KIND:
+            return f(kind_view<Py_UCS2>(PyUnicode_2BYTE_DATA(ob), len));
+        default:
+            return f(kind_view<Py_UCS4>(PyUnicode_4BYTE_DATA(ob), len));
+        }
+    }
+
+    /**
+       Coerce to a `nonnull` object.
+
+       @see nonnull
+       @throws pyutil::bad_nonnull Thrown when `ob == nullptr`.
+       @return this converted to a `nonnull` object.
+    */
+    nonnull<object> as_nonnull() const;
+
+    /**
+       Create a temporary reference. This is a reference that will
+       decref the object when it is destroyed.
+
+       @return this converted into a tmpref.
+    */
+    tmpref<object> as_tmpref() &&;
+};
+
+/**
+   The type of Python `str` objects.
+
+   This is equivalent to: `str`.
+*/
+extern const type::object<str::object> type;
+
+/**
+   Check if an object is an instance of `str`.
+
+   @param t The object to check
+   @return  1 if `ob` is an instance of `str`, 0 if `ob` is not an
+            instance of `str`, -1 if an exception occured.
+*/
+template<typename T>
+inline int check(const T &t) {
+    if (!t.is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PyUnicode_Check(t);
+}
+
+inline int check(const nonnull<object>&) {
+    return 1;
+}
+
+/**
+   Check if an object is an instance of `str` but not a subclass.
+
+   @param t The object to check
+   @return  1 if `ob` is an instance of `str`, 0 if `ob` is not an
+            instance of `str`, -1 if an exception occured.
+*/
+template<typename T>
+inline int checkexact(const T &t) {
+    if (!t.is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PyUnicode_CheckExact(t);
+}
+
+inline int checkexact(const nonnull<object>&) {
+    return 1;
+}
+}
+}
+
+namespace pyutils {
+template<typename T>
+struct typeformat;
+
+template<>
+struct typeformat<py::str::object> {
+    static char_sequence<'O', '!'> cs;
+
+    template<typename T>
+    static inline auto make_arg(T &&t) {
+        return std::make_tuple(&PyUnicode_Type, std::forward<T>(t));
+    }
+};
+}
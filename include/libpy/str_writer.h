@@ -0,0 +1,168 @@
+#pragma once
+#include <sstream>
+#include <string_view>
+#include <type_traits>
+
+#include "libpy/object.h"
+
+namespace py {
+/**
+   Build a `str` object in place.
+
+   Text is appended directly into a growing unicode buffer without an
+   intermediate `std::string`. ASCII text is copied in as is, other UTF-8
+   text is decoded once when it is written. Python objects are written as
+   their `str()`.
+
+   When a write fails the writer enters a failed state: every further write
+   is ignored and `finalize()` returns `nullptr` with the original exception
+   raised. Like `py::object`, `is_nonnull()` reports if the writer is
+   usable.
+*/
+class str_writer {
+private:
+    _PyUnicodeWriter writer;
+    bool failed;
+
+    int write_integer(long long value);
+    int write_integer(unsigned long long value);
+    int write_floating(long double value);
+
+    /**
+       Record the result of an operation on `writer`.
+    */
+    inline int check(int status) {
+        if (status) {
+            failed = true;
+        }
+        return status;
+    }
+
+public:
+    /**
+       Create a writer.
+
+       @param capacity The number of code points to preallocate.
+    */
+    explicit str_writer(py::ssize_t capacity = 0);
+
+    str_writer(const str_writer&) = delete;
+    str_writer &operator=(const str_writer&) = delete;
+
+    str_writer(str_writer &&mvfrom) noexcept;
+
+    ~str_writer();
+
+    /**
+       Check if the writer is usable.
+
+       @return false if a write has failed.
+    */
+    inline bool is_nonnull() const {
+        return !failed;
+    }
+
+    /**
+       Append UTF-8 encoded text.
+
+       @param cs The text to append.
+       @return   zero on success, non-zero if an exception occured.
+    */
+    int write(std::string_view cs);
+
+    /**
+       Append a single code point.
+
+       @param c The code point to append.
+       @return  zero on success, non-zero if an exception occured.
+    */
+    int put(Py_UCS4 c);
+
+    /**
+       Append the `str()` of a Python object. `str` objects are copied in
+       without any conversion.
+
+       @param ob The object to append.
+       @return   zero on success, non-zero if an exception occured.
+    */
+    int write(const py::object &ob);
+
+    /**
+       Append a value. This formats values like a default `std::ostream`:
+       Python objects are written as their `str()`, strings are written as
+       text, and numbers are formatted in place. Like `std::ostream`, all
+       three `char` types, including `std::int8_t` and `std::uint8_t`, are
+       written as a character, not a number. Other types are formatted with
+       their `std::ostream` `operator<<`. Stream manipulators like
+       `std::hex` are rejected at compile time because there is no stream
+       for them to modify.
+
+       @param value The value to append.
+       @return      zero on success, non-zero if an exception occured.
+    */
+    template<typename T>
+    int write_value(const T &value) {
+        if (failed) {
+            return -1;
+        }
+        if constexpr (std::is_base_of<py::object, T>::value) {
+            return write(static_cast<const py::object&>(value));
+        }
+        else if constexpr (std::is_same<T, char>::value ||
+                           std::is_same<T, signed char>::value ||
+                           std::is_same<T, unsigned char>::value) {
+            return put(static_cast<unsigned char>(value));
+        }
+        else if constexpr (std::is_same<T, bool>::value) {
+            return put(value ? '1' : '0');
+        }
+        else if constexpr (std::is_integral<T>::value &&
+                           std::is_signed<T>::value) {
+            return write_integer(static_cast<long long>(value));
+        }
+        else if constexpr (std::is_integral<T>::value) {
+            return write_integer(static_cast<unsigned long long>(value));
+        }
+        else if constexpr (std::is_floating_point<T>::value) {
+            return write_floating(value);
+        }
+        else if constexpr (std::is_convertible<const T&,
+                                               std::string_view>::value) {
+            return write(std::string_view(value));
+        }
+        else {
+            // each value is formatted on a fresh stream, so a manipulator
+            // like `std::hex` would silently not apply to the next value
+            static_assert(
+                !(std::is_function<std::remove_pointer_t<T>>::value &&
+                  (std::is_invocable<const T&, std::ios_base&>::value ||
+                   std::is_invocable<const T&, std::ostream&>::value)),
+                "stream manipulators are not supported, format the value "
+                "before writing it");
+            std::ostringstream stream;
+            stream << value;
+            return write(stream.str());
+        }
+    }
+
+    /**
+       Append a value.
+
+       @see write_value
+       @param value The value to append.
+       @return      `*this` for chaining.
+    */
+    template<typename T>
+    inline str_writer &operator<<(const T &value) {
+        write_value(value);
+        return *this;
+    }
+
+    /**
+       Take the result. The writer is reset to an empty state.
+
+       @return The `str` object or `nullptr` if an exception occured.
+    */
+    tmpref<py::object> finalize();
+};
+}
@@ -1,7 +1,15 @@
 #pragma once
+#include <array>
+#include <iterator>
+#include <optional>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "libpy/box.h"
 #include "libpy/object.h"
+#include "libpy/slice.h"
 #include "libpy/type.h"
 
 namespace py {
@@ -24,6 +32,19 @@ protected:
     return reinterpret_cast<py::object*>(
         reinterpret_cast<PyTupleObject* const>(ob)->ob_item);
     }
+
+    /**
+       Convert each element of the tuple into the matching element of
+       `out` with `py::from_python`.
+    */
+    template<typename Tuple, std::size_t... ixs>
+    int unpack_into(Tuple &out, std::index_sequence<ixs...>) const {
+        PyObject *const *items = reinterpret_cast<PyTupleObject*>(ob)->ob_item;
+        bool ok = (!py::from_python<std::tuple_element_t<ixs, Tuple>>::f(
+                       items[ixs], std::get<ixs>(out)) && ...);
+        return ok ? 0 : -1;
+    }
+
 public:
     friend class py::tmpref<object>;
 
@@ -96,7 +117,7 @@ public:
     template<typename I,
              typename = std::enable_if_t<std::is_integral<I>::value>>
     py::object getitem(I idx) const {
-        return *this[idx];
+        return (*this)[idx];
     }
 
     /**
@@ -160,6 +181,177 @@ public:
         return PyTuple_SetItem(ob, idx, value);
     }
 
+    /**
+       Unbox each element of the tuple into a `std::vector`.
+
+       `out` is resized to the length of the tuple and overwritten, so a
+       buffer may be reused across calls without reallocating. Exact `int`
+       and `float` elements are read directly; see `py::unbox` for the
+       conversion rules.
+
+       @param out The vector to write the values into.
+       @return -1 on failure, otherwise zero. On failure the contents of
+               `out` are unspecified.
+    */
+    template<typename T>
+    int to_vector(std::vector<T> &out) const {
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return -1;
+        }
+
+        py::ssize_t len = PyTuple_GET_SIZE(ob);
+        out.resize(len);
+        PyObject *const *items = reinterpret_cast<PyTupleObject*>(ob)->ob_item;
+        if constexpr (std::is_same<T, bool>::value) {
+            // `std::vector<bool>` is not contiguous
+            for (py::ssize_t ix = 0; ix < len; ++ix) {
+                bool value;
+                if (py::unbox(items[ix], value)) {
+                    return -1;
+                }
+                out[ix] = value;
+            }
+            return 0;
+        }
+        else {
+            return py::unbox_range(out.data(), items, len);
+        }
+    }
+
+    /**
+       View `this[start:stop:step]` without copying.
+
+       Bounds follow Python's slicing rules: negative bounds count from the
+       end and out of range bounds are clipped. Pass `py::slice_end` as
+       `stop` to run to the end of the tuple, or to the front with a negative
+       step.
+
+       @param start The start bound.
+       @param stop  The stop bound.
+       @param step  The step, which may not be zero.
+       @return      A borrowed view of the items. If `step` is zero or `ob`
+                    is `nullptr` the view is not valid and a Python
+                    exception is raised.
+    */
+    item_span slice(py::ssize_t start,
+                    py::ssize_t stop = slice_end,
+                    py::ssize_t step = 1) const;
+
+    /**
+       View `this[start:stop:step]` without copying, where the bounds are
+       known at compile time.
+
+       @see slice
+    */
+    template<py::ssize_t start,
+             py::ssize_t stop = slice_end,
+             py::ssize_t step = 1>
+    item_span slice() const {
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return item_span();
+        }
+        return make_item_span<start, stop, step>(
+            reinterpret_cast<PyTupleObject*>(ob)->ob_item,
+            PyTuple_GET_SIZE(ob));
+    }
+
+    /**
+       Copy `this[start:stop:step]` into a new tuple.
+
+       @see slice
+       @return A new tuple or nullptr.
+    */
+    tmpref<object> slice_copy(py::ssize_t start,
+                              py::ssize_t stop = slice_end,
+                              py::ssize_t step = 1) const;
+
+    /**
+       Get the object at a Python-style index known at compile time, with
+       bounds checking. Negative indices count from the end.
+
+       When the index is out of bounds this will return
+       `py::object(nullptr)` and set a Python `IndexError`.
+
+       @return A borrowed reference to the object at index `ix`.
+    */
+    template<py::ssize_t ix>
+    py::object at() const {
+        if (!is_nonnull()) {
+            pyutils::failed_null_check();
+            return nullptr;
+        }
+        py::ssize_t normalized = normalize_index<ix>(PyTuple_GET_SIZE(ob));
+        if (normalized < 0) {
+            PyErr_SetString(PyExc_IndexError, "tuple index out of range");
+            return nullptr;
+        }
+        return PyTuple_GET_ITEM(ob, normalized);
+    }
+
+    /**
+       Check that the tuple has exactly `len` elements.
+
+       @return zero if it does, otherwise non-zero and a Python exception
+               is raised.
+    */
+    int check_arity(py::ssize_t len) const;
+
+    /**
+       Unpack a tuple of known length into borrowed references with a
+       single null and length check.
+
+       ```
+       auto [a, b, c] = t.unpack<3>();
+       ```
+
+       @return The elements of the tuple. If `ob` is `nullptr` or the tuple
+               does not have `N` elements, every element is `nullptr` and a
+               Python exception is raised.
+    */
+    template<std::size_t N>
+    std::array<py::object, N> unpack() const {
+        std::array<py::object, N> out;
+        if (check_arity(N)) {
+            return out;
+        }
+        PyObject *const *items = reinterpret_cast<PyTupleObject*>(ob)->ob_item;
+        for (std::size_t ix = 0; ix < N; ++ix) {
+            out[ix] = items[ix];
+        }
+        return out;
+    }
+
+    /**
+       Unpack and convert a tuple of known length in a single pass. Each
+       element is converted with `py::from_python` from `libpy/convert.h`,
+       so numeric elements are unboxed directly and `py::object` elements
+       are borrowed.
+
+       ```
+       if (auto row = t.unpack<long, double, py::object>()) {
+           auto [a, b, c] = *row;
+       }
+       ```
+
+       @return The converted elements, or `std::nullopt` with a Python
+               exception raised if the tuple has the wrong length or an
+               element cannot be converted.
+    */
+    template<typename... Ts,
+             typename = std::enable_if_t<(sizeof...(Ts) > 0)>>
+    std::optional<std::tuple<Ts...>> unpack() const {
+        if (check_arity(sizeof...(Ts))) {
+            return std::nullopt;
+        }
+        std::tuple<Ts...> out;
+        if (unpack_into(out, std::index_sequence_for<Ts...>{})) {
+            return std::nullopt;
+        }
+        return out;
+    }
+
     /**
        Coerce to a `nonnull` object.
 
@@ -231,31 +423,94 @@ inline int checkexact(const nonnull<object>&) {
     return 1;
 }
 
+/**
+   Create a new tuple from a Python iterable.
+
+   This is the implementation of `from_iterable` for `py::object`s.
+
+   @param seq The iterable to create a tuple from.
+   @return A new tuple or nullptr.
+*/
+tmpref<object> _from_py_iterable(const py::object &seq);
+
 /**
    Create a new tuple from another iterable object.
 
+   An exact `tuple` input is returned as is and an exact `list` input is
+   copied with a single pass over its storage. Other Python iterables do not
+   need to be sized: the result is preallocated from `lenhint()`, grown
+   geometrically, and trimmed at the end.
+   C++ ranges of `py::object` must provide `size()`.
+
    @param seq The sequence to create a tuple from.
    @return A new tuple or nullptr.
 */
 template<typename T>
-tmpref<object> from_iterable(T seq) {
+tmpref<object> from_iterable(const T &seq) {
     if (!pyutils::is_nonnull(seq)) {
         pyutils::failed_null_check();
         return nullptr;
     }
 
-    tmpref<object> ob(seq.size());
-    ssize_t n = 0;
-
-    for (auto elem : seq) {
-        if (!elem.is_nonnull()) {
+    if constexpr (std::is_base_of<py::object, T>::value) {
+        return tuple::_from_py_iterable(seq);
+    }
+    else {
+        tmpref<object> ob(static_cast<py::ssize_t>(seq.size()));
+        if (!ob.is_nonnull()) {
             return nullptr;
         }
-        ob.setitem(n++, elem.incref());
+
+        py::ssize_t n = 0;
+        for (const py::object &elem : seq) {
+            if (!elem.is_nonnull()) {
+                pyutils::failed_null_check();
+                return nullptr;
+            }
+            ob.setitem(n++, elem.incref());
+        }
+        return ob;
     }
+}
 
+/**
+   Create a new tuple by boxing each element of a contiguous C++ array.
+
+   The tuple is allocated once and filled in a single pass. Repeated values
+   share a boxed object and small integers come from the interpreter's
+   cache; see `py::box_range`.
+
+   @param data The values to box.
+   @param len  The number of values in `data`.
+   @return A new tuple or nullptr.
+*/
+template<typename T>
+tmpref<object> from_range(const T *data, py::ssize_t len) {
+    tmpref<object> ob(len);
+    if (!ob.is_nonnull()) {
+        return nullptr;
+    }
+    PyObject **items = reinterpret_cast<PyTupleObject*>(
+        static_cast<PyObject*>(ob))->ob_item;
+    if (py::box_range(items, data, len)) {
+        return nullptr;
+    }
     return ob;
 }
+
+/**
+   Create a new tuple by boxing each element of a contiguous C++ range, for
+   example a `std::vector` or `std::array`.
+
+   @param range The values to box.
+   @return A new tuple or nullptr.
+*/
+template<typename R,
+         typename = decltype(std::data(std::declval<const R&>()))>
+tmpref<object> from_range(const R &range) {
+    return tuple::from_range(std::data(range),
+                             static_cast<py::ssize_t>(std::size(range)));
+}
 }
 
 /**
@@ -318,3 +573,8 @@ struct typeformat<py::tuple::object> {
     }
 };
 }
+
+// `object::unpack<Ts...>` converts the elements with `py::from_python`.
+// convert.h includes this header, so it is included after the tuple
+// definitions are complete.
+#include "libpy/convert.h"
@@ -53,6 +53,21 @@ class bad_nonnull : public std::exception {};
 */
 void failed_null_check();
 
+/**
+   Check if a `py::object` does not wrap a nullptr.
+*/
+template<typename T>
+inline bool _arg_nonnull(const T &a) {
+    return a.is_nonnull();
+}
+
+/**
+   Check if a raw `PyObject*` is not nullptr.
+*/
+inline bool _arg_nonnull(PyObject *a) {
+    return a;
+}
+
 /**
    Check if all the inputs not nullptr or py::objects that wrap a nullptr.
 
@@ -71,7 +86,7 @@ inline bool all_nonnull() {
 */
 template<typename T>
 inline bool all_nonnull(const T &a) {
-    return a.is_nonnull();
+    return _arg_nonnull(a);
 }
 
 /**
@@ -81,7 +96,7 @@ inline bool all_nonnull(const T &a) {
 */
 template<typename T, typename... Ts>
 inline bool all_nonnull(const T &head, const Ts&... tail) {
-    return head.is_nonnull() && all_nonnull(tail...);
+    return _arg_nonnull(head) && all_nonnull(tail...);
 }
 
 template<char... cs>
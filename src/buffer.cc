@@ -0,0 +1,104 @@
+#include <cstring>
+
+#include "libpy/buffer.h"
+
+namespace {
+/**
+   Split a struct module format string into its byte order prefix and type
+   character.
+
+   @param fmt       The format string. `nullptr` means unsigned bytes.
+   @param byteorder Set to the byte order prefix or `'@'` if there is none.
+   @param code      Set to the single type character.
+   @return          zero on success, non-zero if `fmt` does not describe a
+                    single element.
+*/
+int split_format(const char *fmt, char &byteorder, char &code) {
+    if (!fmt) {
+        byteorder = '@';
+        code = 'B';
+        return 0;
+    }
+    byteorder = '@';
+    if (*fmt && std::strchr("@=<>!", *fmt)) {
+        byteorder = *fmt++;
+    }
+    code = *fmt;
+    return !code || fmt[1];
+}
+
+/**
+   Check if a byte order prefix matches the native byte order.
+*/
+bool native_byteorder(char byteorder) {
+#if PY_BIG_ENDIAN
+    return byteorder != '<';
+#else
+    return byteorder != '>' && byteorder != '!';
+#endif
+}
+
+/**
+   The kind of a struct module type character.
+
+   @return The kind or `'\0'` if the type character is not a scalar.
+*/
+char format_kind(char code) {
+    switch (code) {
+    case 'b':
+    case 'h':
+    case 'i':
+    case 'l':
+    case 'q':
+    case 'n':
+        return static_cast<char>(py::buffer_kind::signed_int);
+    case 'B':
+    case 'H':
+    case 'I':
+    case 'L':
+    case 'Q':
+    case 'N':
+        return static_cast<char>(py::buffer_kind::unsigned_int);
+    case 'e':
+    case 'f':
+    case 'd':
+        return static_cast<char>(py::buffer_kind::floating);
+    case '?':
+        return static_cast<char>(py::buffer_kind::boolean);
+    case 'c':
+        return static_cast<char>(py::buffer_kind::character);
+    default:
+        return '\0';
+    }
+}
+}
+
+int py::buffer_check(const Py_buffer &buf,
+                     py::buffer_kind kind,
+                     py::ssize_t itemsize,
+                     int ndim) {
+    char byteorder;
+    char code;
+
+    if (split_format(buf.format, byteorder, code) ||
+        !native_byteorder(byteorder) ||
+        format_kind(code) != static_cast<char>(kind) ||
+        buf.itemsize != itemsize) {
+        PyErr_Format(PyExc_TypeError,
+                     "buffer has format '%s' with itemsize %zd which does "
+                     "not match the expected type with itemsize %zd",
+                     buf.format ? buf.format : "B",
+                     buf.itemsize,
+                     itemsize);
+        return -1;
+    }
+    if (buf.ndim != ndim) {
+        PyErr_Format(PyExc_ValueError,
+                     "expected a buffer with %d dimension%s, got %d",
+                     ndim,
+                     ndim == 1 ? "" : "s",
+                     buf.ndim);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <limits>
+
+#include "libpy/bytes_writer.h"
+
+py::bytes_writer::bytes_writer(py::ssize_t capacity)
+    : ob(nullptr), len(0), cap(0), failed(false) {
+    if (capacity > 0) {
+        grow(capacity);
+    }
+}
+
+py::bytes_writer::bytes_writer(bytes_writer &&mvfrom) noexcept
+    : ob(mvfrom.ob), len(mvfrom.len), cap(mvfrom.cap), failed(mvfrom.failed) {
+    mvfrom.ob = nullptr;
+    mvfrom.len = mvfrom.cap = 0;
+    mvfrom.failed = false;
+}
+
+py::bytes_writer &
+py::bytes_writer::operator=(bytes_writer &&mvfrom) noexcept {
+    Py_XDECREF(ob);
+    ob = mvfrom.ob;
+    len = mvfrom.len;
+    cap = mvfrom.cap;
+    failed = mvfrom.failed;
+    mvfrom.ob = nullptr;
+    mvfrom.len = mvfrom.cap = 0;
+    mvfrom.failed = false;
+    return *this;
+}
+
+py::bytes_writer::~bytes_writer() {
+    Py_XDECREF(ob);
+}
+
+int py::bytes_writer::grow(py::ssize_t needed) {
+    constexpr py::ssize_t max_size =
+        std::numeric_limits<py::ssize_t>::max() - sizeof(PyBytesObject);
+
+    if (needed > max_size) {
+        PyErr_NoMemory();
+        failed = true;
+        Py_CLEAR(ob);
+        return -1;
+    }
+    // grow by at least half of the current size so that a sequence of
+    // small writes only reallocates a logarithmic number of times
+    py::ssize_t new_cap = std::max(needed,
+                                   cap + std::min(cap / 2, max_size - cap));
+
+    if (!ob) {
+        // start from a fresh object: the empty bytes object is a shared
+        // singleton which cannot be resized in place
+        ob = PyBytes_FromStringAndSize(nullptr, new_cap);
+        if (!ob) {
+            failed = true;
+            return -1;
+        }
+    }
+    else if (_PyBytes_Resize(&ob, new_cap)) {
+        // `_PyBytes_Resize` released the old object
+        failed = true;
+        return -1;
+    }
+    cap = new_cap;
+    return 0;
+}
+
+py::tmpref<py::object> py::bytes_writer::finalize() {
+    if (failed) {
+        pyutils::failed_null_check();
+        return nullptr;
+    }
+
+    PyObject *out = ob;
+    py::ssize_t out_len = len;
+    ob = nullptr;
+    len = cap = 0;
+
+    if (!out_len) {
+        Py_XDECREF(out);
+        return PyBytes_FromStringAndSize(nullptr, 0);
+    }
+    if (_PyBytes_Resize(&out, out_len)) {
+        return nullptr;
+    }
+    return out;
+}
@@ -0,0 +1,212 @@
+#include "libpy/dict.h"
+#include "libpy/utils.h"
+
+namespace {
+namespace d = py::dict;
+
+/**
+   Raise a `KeyError` for `key`. The key is wrapped in a tuple so that tuple
+   keys are not unpacked into the exception's args.
+*/
+void raise_key_error(PyObject *key) {
+    PyObject *args = PyTuple_Pack(1, key);
+    if (args) {
+        PyErr_SetObject(PyExc_KeyError, args);
+        Py_DECREF(args);
+    }
+}
+}
+
+const py::type::object<d::object> d::type(&PyDict_Type);
+
+d::object::object() : py::object() {}
+
+d::object::object(PyObject *pob) : py::object(pob) {
+    dict_check();
+}
+
+d::object::object(const py::object &pob) : py::object(pob) {
+    dict_check();
+}
+
+d::object::object(const d::object &cpfrom) : py::object(cpfrom.ob) {}
+
+d::object::object(d::object &&mvfrom) noexcept : py::object(mvfrom.ob) {
+    mvfrom.ob = nullptr;
+}
+
+d::object::object(int len) : py::object(_PyDict_NewPresized(len)) {}
+
+d::object::object(std::size_t len) : py::object(_PyDict_NewPresized(len)) {}
+
+d::object::object(py::ssize_t len) : py::object(_PyDict_NewPresized(len)) {}
+
+void d::object::dict_check() {
+    if (ob && !PyDict_Check(ob)) {
+        ob = nullptr;
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError,
+                            "cannot make py::dict::object from non dict");
+        }
+    }
+}
+
+d::object::const_iterator d::object::cbegin() const {
+    // a null dict produces the end marker
+    return d::const_iterator(ob);
+}
+
+d::object::const_iterator d::object::cend() const {
+    return d::const_iterator();
+}
+
+d::object::iterator d::object::begin() const {
+    return cbegin();
+}
+
+d::object::iterator d::object::end() const {
+    return cend();
+}
+
+py::ssize_t d::object::len() const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return reinterpret_cast<PyDictObject*>(ob)->ma_used;
+}
+
+py::object d::object::operator[](const py::hashed_key &key) const {
+    if (!pyutils::all_nonnull(*this, key)) {
+        pyutils::failed_null_check();
+        return nullptr;
+    }
+#if LIBPY_HAVE_DICT_KNOWN_HASH
+    PyObject *value = _PyDict_GetItem_KnownHash(ob, key, key.hash());
+#else
+    PyObject *value = PyDict_GetItemWithError(ob, key);
+#endif
+    if (!value && !PyErr_Occurred()) {
+        raise_key_error(key);
+    }
+    return value;
+}
+
+py::object d::object::getitem(const py::hashed_key &key) const {
+    return (*this)[key];
+}
+
+int d::object::setitem(const py::hashed_key &key,
+                       const py::object &value) const {
+    if (!pyutils::all_nonnull(*this, key, value)) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+#if LIBPY_HAVE_DICT_KNOWN_HASH
+    return _PyDict_SetItem_KnownHash(ob, key, value, key.hash());
+#else
+    return PyDict_SetItem(ob, key, value);
+#endif
+}
+
+int d::object::delitem(const py::hashed_key &key) const {
+    if (!pyutils::all_nonnull(*this, key)) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+#if LIBPY_HAVE_DICT_KNOWN_HASH
+    return _PyDict_DelItem_KnownHash(ob, key, key.hash());
+#else
+    return PyDict_DelItem(ob, key);
+#endif
+}
+
+int d::object::contains(const py::hashed_key &key) const {
+    if (!pyutils::all_nonnull(*this, key)) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+#if PY_VERSION_HEX >= 0x030A0000
+    return _PyDict_Contains_KnownHash(ob, key, key.hash());
+#elif LIBPY_HAVE_DICT_KNOWN_HASH
+    return _PyDict_Contains(ob, key, key.hash());
+#else
+    return PyDict_Contains(ob, key);
+#endif
+}
+
+py::object d::object::get(const py::object &key) const {
+    if (!pyutils::all_nonnull(*this, key)) {
+        pyutils::failed_null_check();
+        return nullptr;
+    }
+    return PyDict_GetItemWithError(ob, key);
+}
+
+py::object d::object::get(const py::hashed_key &key) const {
+    if (!pyutils::all_nonnull(*this, key)) {
+        pyutils::failed_null_check();
+        return nullptr;
+    }
+#if LIBPY_HAVE_DICT_KNOWN_HASH
+    return _PyDict_GetItem_KnownHash(ob, key, key.hash());
+#else
+    return PyDict_GetItemWithError(ob, key);
+#endif
+}
+
+py::object d::object::get(const py::object &key,
+                          const py::object &default_) const {
+    py::object value = get(key);
+    if (!value.is_nonnull() && !PyErr_Occurred()) {
+        return default_;
+    }
+    return value;
+}
+
+py::object d::object::get(const py::hashed_key &key,
+                          const py::object &default_) const {
+    py::object value = get(key);
+    if (!value.is_nonnull() && !PyErr_Occurred()) {
+        return default_;
+    }
+    return value;
+}
+
+py::object d::object::setdefault(const py::object &key,
+                                 const py::object &default_) const {
+    if (!pyutils::all_nonnull(*this, key, default_)) {
+        pyutils::failed_null_check();
+        return nullptr;
+    }
+    return PyDict_SetDefault(ob, key, default_);
+}
+
+py::object d::object::setdefault(const py::hashed_key &key,
+                                 const py::object &default_) const {
+    if (!pyutils::all_nonnull(*this, key, default_)) {
+        pyutils::failed_null_check();
+        return nullptr;
+    }
+    py::object value = get(key);
+    if (value.is_nonnull() || PyErr_Occurred()) {
+        return value;
+    }
+    if (setitem(key, default_)) {
+        return nullptr;
+    }
+    return default_;
+}
+
+py::nonnull<d::object> d::object::as_nonnull() const {
+    if (!is_nonnull()) {
+        throw pyutils::bad_nonnull();
+    }
+    return nonnull<d::object>(ob);
+}
+
+py::tmpref<d::object> d::object::as_tmpref() && {
+    tmpref<d::object> ret(ob);
+    ob = nullptr;
+    return ret;
+}
@@ -1,7 +1,138 @@
+#include <array>
+#include <memory>
+#include <utility>
+
 #include "libpy/err.h"
 
 namespace {
 namespace e = py::err;
+
+/**
+   The placeholder message object for `raise_lazy`.
+*/
+struct lazy_message_object {
+    PyObject_HEAD
+    e::_lazy_message *message;
+    PyObject *formatted;
+};
+
+/**
+   Format the message the first time it is needed.
+
+   @return A borrowed reference to the message or nullptr.
+*/
+PyObject *lazy_message_format(PyObject *self) {
+    lazy_message_object *lazy = reinterpret_cast<lazy_message_object*>(self);
+    if (!lazy->formatted) {
+        py::str_writer writer;
+        if (lazy->message) {
+            // the message is only missing after the parts were cleared by
+            // the garbage collector
+            lazy->message->write(writer);
+        }
+        py::tmpref<py::object> formatted = writer.finalize();
+        if (!formatted.is_nonnull()) {
+            return nullptr;
+        }
+        lazy->formatted = formatted;
+        std::move(formatted).invalidate();
+
+        // the parts may hold references, drop them as soon as possible
+        delete lazy->message;
+        lazy->message = nullptr;
+    }
+    return lazy->formatted;
+}
+
+int lazy_message_traverse(PyObject *self, visitproc visit, void *arg) {
+    lazy_message_object *lazy = reinterpret_cast<lazy_message_object*>(self);
+    if (lazy->message) {
+        return lazy->message->traverse(visit, arg);
+    }
+    return 0;
+}
+
+int lazy_message_clear(PyObject *self) {
+    lazy_message_object *lazy = reinterpret_cast<lazy_message_object*>(self);
+    e::_lazy_message *message = lazy->message;
+    lazy->message = nullptr;
+    delete message;
+    return 0;
+}
+
+void lazy_message_dealloc(PyObject *self) {
+    lazy_message_object *lazy = reinterpret_cast<lazy_message_object*>(self);
+    PyTypeObject *type = Py_TYPE(self);
+    PyObject_GC_UnTrack(self);
+    lazy_message_clear(self);
+    Py_XDECREF(lazy->formatted);
+    PyObject_GC_Del(self);
+    Py_DECREF(type);
+}
+
+/**
+   Pickle the message as the formatted `str` so that exceptions raised
+   with `raise_lazy` may be sent between processes.
+*/
+PyObject *lazy_message_reduce(PyObject *self, PyObject*) {
+    PyObject *formatted = lazy_message_format(self);
+    if (!formatted) {
+        return nullptr;
+    }
+    return Py_BuildValue("(O(O))", &PyUnicode_Type, formatted);
+}
+
+PyObject *lazy_message_str(PyObject *self) {
+    PyObject *formatted = lazy_message_format(self);
+    Py_XINCREF(formatted);
+    return formatted;
+}
+
+PyObject *lazy_message_repr(PyObject *self) {
+    PyObject *formatted = lazy_message_format(self);
+    return formatted ? PyObject_Repr(formatted) : nullptr;
+}
+
+Py_hash_t lazy_message_hash(PyObject *self) {
+    PyObject *formatted = lazy_message_format(self);
+    return formatted ? PyObject_Hash(formatted) : -1;
+}
+
+PyObject *lazy_message_richcompare(PyObject *self, PyObject *other, int op) {
+    PyObject *formatted = lazy_message_format(self);
+    return formatted ? PyObject_RichCompare(formatted, other, op) : nullptr;
+}
+
+PyTypeObject *lazy_message_type() {
+    static PyTypeObject *type = nullptr;
+    if (!type) {
+        static PyMethodDef methods[] = {
+            {"__reduce__", lazy_message_reduce, METH_NOARGS, nullptr},
+            {nullptr, nullptr, 0, nullptr},
+        };
+        static PyType_Slot slots[] = {
+            {Py_tp_dealloc, reinterpret_cast<void*>(lazy_message_dealloc)},
+            {Py_tp_traverse, reinterpret_cast<void*>(lazy_message_traverse)},
+            {Py_tp_clear, reinterpret_cast<void*>(lazy_message_clear)},
+            {Py_tp_methods, methods},
+            {Py_tp_str, reinterpret_cast<void*>(lazy_message_str)},
+            {Py_tp_repr, reinterpret_cast<void*>(lazy_message_repr)},
+            {Py_tp_hash, reinterpret_cast<void*>(lazy_message_hash)},
+            {Py_tp_richcompare,
+             reinterpret_cast<void*>(lazy_message_richcompare)},
+            {0, nullptr},
+        };
+        static PyType_Spec spec = {
+            "libpy.lazy_message",
+            sizeof(lazy_message_object),
+            0,
+            Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+            slots,
+        };
+        type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&spec));
+    }
+    return type;
+}
 }
 
 const e::exctype e::BaseException(PyExc_BaseException);
@@ -45,6 +176,7 @@ const e::exctype e::RecursionError(PyExc_RecursionError);
 #endif
 const e::exctype e::ReferenceError(PyExc_ReferenceError);
 const e::exctype e::RuntimeError(PyExc_RuntimeError);
+const e::exctype e::StopIteration(PyExc_StopIteration);
 const e::exctype e::SyntaxError(PyExc_SyntaxError);
 const e::exctype e::SystemError(PyExc_SystemError);
 const e::exctype e::TimeoutError(PyExc_TimeoutError);
@@ -139,12 +271,15 @@ void py::err::object::cause(py::object cs) {
 py::err::msgbuilder::msgbuilder(py::err::exctype type) :
     type(type), fire(true) {}
 py::err::msgbuilder::msgbuilder(msgbuilder &&mvfrom) noexcept :
-    std::stringstream(std::forward<msgbuilder>(mvfrom)), type(mvfrom.type) {
+    type(mvfrom.type), writer(std::move(mvfrom.writer)), fire(mvfrom.fire) {
     mvfrom.fire = false;
 }
 py::err::msgbuilder::~msgbuilder() {
     if (fire) {
-        PyErr_SetString(type, str().c_str());
+        tmpref<py::object> msg = writer.finalize();
+        if (msg.is_nonnull()) {
+            PyErr_SetObject(type, msg);
+        }
     }
 }
 
@@ -155,3 +290,91 @@ py::err::msgbuilder py::err::raise(py::err::exctype type) {
 void py::err::raise(py::err::object err) {
     PyErr_SetObject(err.type(), err);
 }
+
+PyObject *
+py::err::_lazy_message_object(std::unique_ptr<py::err::_lazy_message> message) {
+    PyTypeObject *type = lazy_message_type();
+    if (!type) {
+        return nullptr;
+    }
+    lazy_message_object *ob = PyObject_GC_New(lazy_message_object, type);
+    if (!ob) {
+        return nullptr;
+    }
+#if PY_VERSION_HEX < 0x03080000
+    // before 3.8 instances of heap types do not own a reference to their
+    // type, but `lazy_message_dealloc` releases one
+    Py_INCREF(type);
+#endif
+    ob->message = message.release();
+    ob->formatted = nullptr;
+    PyObject_GC_Track(ob);
+    return reinterpret_cast<PyObject*>(ob);
+}
+
+namespace {
+/**
+   Check if a cached sentinel instance may be raised again: nothing else
+   holds it and it carries no state from a previous raise, like arguments,
+   attributes, notes, a cause, or the `value` of a `StopIteration`.
+   Exception types with other fields of their own are never reused.
+*/
+bool sentinel_reusable(PyObject *instance) {
+    if (Py_REFCNT(instance) != 1) {
+        return false;
+    }
+    PyBaseExceptionObject *exc =
+        reinterpret_cast<PyBaseExceptionObject*>(instance);
+    if (!exc->args || PyTuple_GET_SIZE(exc->args) || exc->cause) {
+        return false;
+    }
+    if (exc->dict && PyDict_Size(exc->dict)) {
+        return false;
+    }
+#if PY_VERSION_HEX >= 0x030B0000
+    if (exc->notes) {
+        return false;
+    }
+#endif
+    if (Py_TYPE(instance) == reinterpret_cast<PyTypeObject*>(
+            PyExc_StopIteration)) {
+        return reinterpret_cast<PyStopIterationObject*>(instance)->value ==
+            Py_None;
+    }
+    return Py_TYPE(instance)->tp_basicsize ==
+        static_cast<py::ssize_t>(sizeof(PyBaseExceptionObject));
+}
+}
+
+std::nullptr_t py::err::raise_sentinel(py::err::exctype type) {
+    // pairs of (type, instance), the cache owns a reference to both
+    static std::array<std::pair<PyObject*, PyObject*>, 8> cache{};
+
+    for (auto &[cached_type, instance] : cache) {
+        if (cached_type && cached_type != type) {
+            continue;
+        }
+        if (cached_type && sentinel_reusable(instance)) {
+            PyException_SetTraceback(instance, Py_None);
+            PyException_SetContext(instance, nullptr);
+            reinterpret_cast<PyBaseExceptionObject*>(
+                instance)->suppress_context = 0;
+        }
+        else {
+            PyObject *fresh = PyObject_CallObject(type, nullptr);
+            if (!fresh) {
+                return nullptr;
+            }
+            if (!cached_type) {
+                cached_type = type.incref();
+            }
+            Py_XDECREF(instance);
+            instance = fresh;
+        }
+        PyErr_SetObject(type, instance);
+        return nullptr;
+    }
+
+    PyErr_SetNone(type);
+    return nullptr;
+}
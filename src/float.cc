@@ -0,0 +1,94 @@
+#include <cmath>
+#include <string>
+
+#include "libpy/float.h"
+#include "libpy/utils.h"
+
+const py::float_::object &
+py::float_::_fill_literal(py::float_::object &slot, const char *literal) {
+    // drop the digit separators
+    std::string digits;
+    for (const char *c = literal; *c; ++c) {
+        if (*c != '\'') {
+            digits.push_back(*c);
+        }
+    }
+
+    // parse with Python instead of `strtod`, which depends on the locale
+    if (digits.size() > 1 && digits[0] == '0' &&
+        (digits[1] == 'x' || digits[1] == 'X')) {
+        slot.ob = PyObject_CallMethod(reinterpret_cast<PyObject*>(
+                                          &PyFloat_Type),
+                                      "fromhex",
+                                      "s",
+                                      digits.c_str());
+        return slot;
+    }
+    double value = PyOS_string_to_double(digits.c_str(), nullptr, nullptr);
+    if (value == -1.0 && PyErr_Occurred()) {
+        return slot;
+    }
+    slot.ob = PyFloat_FromDouble(value);
+    return slot;
+}
+
+const py::type::object<py::float_::object> py::float_::type(&PyFloat_Type);
+
+py::float_::object::object() : py::object(nullptr) {}
+
+py::float_::object::object(PyObject *pob) : py::object(pob) {
+    float_check();
+}
+
+py::float_::object::object(const py::object &pob) : py::object(pob) {
+    float_check();
+}
+
+py::float_::object::object(const py::float_::object &cpfrom) :
+    py::object(cpfrom.ob) {}
+
+py::float_::object::object(py::float_::object &&mvfrom) noexcept :
+    py::object(mvfrom.ob) {
+    mvfrom.ob = nullptr;
+}
+
+void py::float_::object::float_check() {
+    if (ob && !PyFloat_Check(ob)) {
+        ob = nullptr;
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError,
+                            "cannot make py::float_::object from non float");
+        }
+    }
+}
+
+py::nonnull<py::float_::object> py::float_::object::as_nonnull() const {
+    if (!is_nonnull()) {
+        throw pyutils::bad_nonnull();
+    }
+    return py::nonnull<py::float_::object>(ob);
+}
+
+py::tmpref<py::float_::object> py::float_::object::as_tmpref() && {
+    py::tmpref<object> ret(ob);
+    ob = nullptr;
+    return ret;
+}
+
+py::tmpref<py::float_::object> py::float_::object::operator-() const {
+    if (ob && PyFloat_CheckExact(ob)) {
+        return PyFloat_FromDouble(-PyFloat_AS_DOUBLE(ob));
+    }
+    return ob_unary_func<PyNumber_Negative>();
+}
+
+py::tmpref<py::float_::object> py::float_::object::operator+() const {
+    return ob_unary_func<PyNumber_Positive>();
+}
+
+py::tmpref<py::float_::object> py::float_::object::abs() const {
+    if (ob && PyFloat_CheckExact(ob)) {
+        return PyFloat_FromDouble(std::fabs(PyFloat_AS_DOUBLE(ob)));
+    }
+    return ob_unary_func<PyNumber_Absolute>();
+}
@@ -0,0 +1,680 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+#include "libpy/kernels.h"
+#include "libpy/tuple.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define LIBPY_KERNELS_X86 1
+#else
+#define LIBPY_KERNELS_X86 0
+#endif
+
+/**
+   Kernel bodies are force inlined into one wrapper per target so that each
+   wrapper gets its own copy compiled for that instruction set.
+*/
+#define LIBPY_KERNEL inline __attribute__((always_inline))
+
+// vectors are only passed by value between always inlined functions so the
+// ABI of the baseline target does not matter
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace {
+namespace k = py::kernels;
+
+/**
+   The size of the generic vectors used by the kernels. This is one AVX-512
+   register; narrower targets split each operation across registers which
+   also gives them more independent accumulators.
+*/
+constexpr std::size_t vector_bytes = 64;
+
+template<typename T>
+struct vec {
+    typedef T type __attribute__((vector_size(vector_bytes)));
+    static constexpr py::ssize_t width = vector_bytes / sizeof(T);
+};
+
+/**
+   The type to do arithmetic in. Integers are computed as unsigned so that
+   overflow wraps instead of being undefined.
+*/
+template<typename T, bool = std::is_integral<T>::value>
+struct arith {
+    using type = T;
+};
+
+template<typename T>
+struct arith<T, true> {
+    using type = std::make_unsigned_t<T>;
+};
+
+template<typename T>
+using arith_type = typename arith<T>::type;
+
+template<typename V, typename T>
+LIBPY_KERNEL V load(const T *data) {
+    V out;
+    std::memcpy(&out, data, sizeof(V));
+    return out;
+}
+
+template<typename T>
+LIBPY_KERNEL const T &at(const T *data, py::ssize_t stride, py::ssize_t ix) {
+    return *reinterpret_cast<const T*>(reinterpret_cast<const char*>(data) +
+                                       ix * stride);
+}
+
+template<typename T>
+LIBPY_KERNEL bool is_nan(T value) {
+    if constexpr (std::is_floating_point<T>::value) {
+        return std::isnan(value);
+    }
+    else {
+        return false;
+    }
+}
+
+/**
+   Get a lane mask which is set for NaN elements of a vector.
+*/
+template<typename V>
+LIBPY_KERNEL auto nan_mask(const V &value) {
+    if constexpr (std::is_floating_point<decltype(+value[0])>::value) {
+        return value != value;
+    }
+    else {
+        return V{} != V{};
+    }
+}
+
+/**
+   A scalar accumulator using Neumaier's variant of Kahan summation.
+*/
+template<typename T>
+struct compensated {
+    arith_type<T> total = 0;
+    arith_type<T> compensation = 0;
+
+    LIBPY_KERNEL void add(arith_type<T> value) {
+        if constexpr (std::is_floating_point<T>::value) {
+            T t = total + value;
+            if (std::abs(total) >= std::abs(value)) {
+                compensation += (total - t) + value;
+            }
+            else {
+                compensation += (value - t) + total;
+            }
+            total = t;
+        }
+        else {
+            total += value;
+        }
+    }
+
+    LIBPY_KERNEL T result() const {
+        return static_cast<T>(total + compensation);
+    }
+};
+
+// contiguous kernel bodies ////////////////////////////////////////////////
+
+/**
+   Sum `f(element)` over a contiguous array. Each vector lane keeps its own
+   Kahan compensation term; the lanes are combined at the end.
+*/
+template<typename T, typename F>
+LIBPY_KERNEL T sum_map(const T *data, py::ssize_t len, F f) {
+    using A = arith_type<T>;
+    using V = typename vec<A>::type;
+    constexpr py::ssize_t width = vec<A>::width;
+
+    V total = {};
+    V compensation = {};
+    py::ssize_t ix = 0;
+    for (; ix + width <= len; ix += width) {
+        V value = f(load<V>(data + ix));
+        if constexpr (std::is_floating_point<T>::value) {
+            V y = value - compensation;
+            V t = total + y;
+            compensation = (t - total) - y;
+            total = t;
+        }
+        else {
+            total += value;
+        }
+    }
+
+    compensated<T> out;
+    for (py::ssize_t lane = 0; lane < width; ++lane) {
+        out.add(total[lane]);
+        out.add(-compensation[lane]);
+    }
+    for (; ix < len; ++ix) {
+        out.add(f(static_cast<A>(data[ix])));
+    }
+    return out.result();
+}
+
+struct identity {
+    template<typename T>
+    LIBPY_KERNEL T operator()(T value) const {
+        return value;
+    }
+};
+
+template<typename T>
+struct squared_deviation {
+    T center;
+
+    template<typename V>
+    LIBPY_KERNEL V operator()(V value) const {
+        V deviation = value - center;
+        return deviation * deviation;
+    }
+};
+
+template<typename T>
+LIBPY_KERNEL T sum_contiguous(const T *data, py::ssize_t len) {
+    return sum_map(data, len, identity{});
+}
+
+template<typename T>
+LIBPY_KERNEL T sum_squared_deviation_contiguous(const T *data,
+                                                py::ssize_t len,
+                                                T center) {
+    return sum_map(data, len, squared_deviation<T>{center});
+}
+
+template<bool is_max, typename T>
+LIBPY_KERNEL auto better(const T &a, const T &b) {
+    if constexpr (is_max) {
+        return a > b;
+    }
+    else {
+        return a < b;
+    }
+}
+
+template<typename T, bool is_max>
+LIBPY_KERNEL T extreme_contiguous(const T *data, py::ssize_t len) {
+    using V = typename vec<T>::type;
+    constexpr py::ssize_t width = vec<T>::width;
+
+    T out = data[0];
+    bool nan = is_nan(out);
+    py::ssize_t ix = 0;
+    if (len >= width) {
+        V best = load<V>(data);
+        auto seen_nan = nan_mask(best);
+        for (ix = width; ix + width <= len; ix += width) {
+            V value = load<V>(data + ix);
+            seen_nan |= nan_mask(value);
+            best = better<is_max>(value, best) ? value : best;
+        }
+        for (py::ssize_t lane = 0; lane < width; ++lane) {
+            if (better<is_max>(best[lane], out)) {
+                out = best[lane];
+            }
+            nan |= seen_nan[lane] != 0;
+        }
+    }
+    for (; ix < len; ++ix) {
+        T value = data[ix];
+        nan |= is_nan(value);
+        if (better<is_max>(value, out)) {
+            out = value;
+        }
+    }
+    if constexpr (std::is_floating_point<T>::value) {
+        if (nan) {
+            return std::numeric_limits<T>::quiet_NaN();
+        }
+    }
+    return out;
+}
+
+template<typename T, bool is_max>
+LIBPY_KERNEL py::ssize_t arg_extreme_contiguous(const T *data,
+                                                py::ssize_t len) {
+    using V = typename vec<T>::type;
+    using I = std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>;
+    typedef I IV __attribute__((vector_size(vector_bytes)));
+    constexpr py::ssize_t width = vec<T>::width;
+    // the lane indices are relative to the start of a block so that 32 bit
+    // indices cannot overflow
+    constexpr py::ssize_t block = (std::numeric_limits<I>::max() / width - 1) *
+                                  width;
+
+    py::ssize_t out = 0;
+    T out_value = data[0];
+    bool nan = false;
+    py::ssize_t base = 0;
+    while (len - base >= width) {
+        py::ssize_t block_len = std::min(block, (len - base) / width * width);
+        const T *block_data = data + base;
+
+        V best = load<V>(block_data);
+        auto seen_nan = nan_mask(best);
+        IV ix;
+        for (py::ssize_t lane = 0; lane < width; ++lane) {
+            ix[lane] = lane;
+        }
+        IV best_ix = ix;
+
+        for (py::ssize_t offset = width;
+             offset < block_len;
+             offset += width) {
+            V value = load<V>(block_data + offset);
+            seen_nan |= nan_mask(value);
+            ix += static_cast<I>(width);
+            auto mask = better<is_max>(value, best);
+            best = mask ? value : best;
+            best_ix = mask ? ix : best_ix;
+        }
+
+        for (py::ssize_t lane = 0; lane < width; ++lane) {
+            py::ssize_t candidate = base + best_ix[lane];
+            if (better<is_max>(best[lane], out_value) ||
+                (best[lane] == out_value && candidate < out)) {
+                out = candidate;
+                out_value = best[lane];
+            }
+            nan |= seen_nan[lane] != 0;
+        }
+        base += block_len;
+    }
+    for (; base < len; ++base) {
+        nan |= is_nan(data[base]);
+        if (better<is_max>(data[base], out_value)) {
+            out = base;
+            out_value = data[base];
+        }
+    }
+    if (nan) {
+        for (py::ssize_t ix = 0; ix < len; ++ix) {
+            if (is_nan(data[ix])) {
+                return ix;
+            }
+        }
+    }
+    return out;
+}
+
+template<typename T>
+struct add_op {
+    LIBPY_KERNEL T operator()(T a, T b) const {
+        return static_cast<T>(static_cast<arith_type<T>>(a) +
+                              static_cast<arith_type<T>>(b));
+    }
+};
+
+template<typename T>
+struct mul_op {
+    LIBPY_KERNEL T operator()(T a, T b) const {
+        return static_cast<T>(static_cast<arith_type<T>>(a) *
+                              static_cast<arith_type<T>>(b));
+    }
+};
+
+template<typename T, typename R, typename Op>
+LIBPY_KERNEL void binary_contiguous(const T *a,
+                                    const T *b,
+                                    R *out,
+                                    py::ssize_t len) {
+    // simple enough for the compiler to vectorize for each target
+    for (py::ssize_t ix = 0; ix < len; ++ix) {
+        out[ix] = Op{}(a[ix], b[ix]);
+    }
+}
+
+template<typename T, typename R, typename Op>
+void binary_strided(const T *a,
+                    py::ssize_t a_stride,
+                    const T *b,
+                    py::ssize_t b_stride,
+                    R *out,
+                    py::ssize_t len) {
+    for (py::ssize_t ix = 0; ix < len; ++ix) {
+        out[ix] = Op{}(at(a, a_stride, ix), at(b, b_stride, ix));
+    }
+}
+
+// dispatch ////////////////////////////////////////////////////////////////
+
+k::target detect_target() {
+#if LIBPY_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return k::target::avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return k::target::avx2;
+    }
+#endif
+    return k::target::baseline;
+}
+
+const k::target best_target = detect_target();
+k::target active = best_target;
+
+#if LIBPY_KERNELS_X86
+template<auto impl, typename... Args>
+__attribute__((target("avx2"))) auto avx2_clone(Args... args) {
+    return impl(args...);
+}
+
+template<auto impl, typename... Args>
+__attribute__((target("avx512f"))) auto avx512_clone(Args... args) {
+    return impl(args...);
+}
+#endif
+
+/**
+   Call the copy of `impl` compiled for the active target.
+*/
+template<auto impl, typename... Args>
+inline auto dispatch(Args... args) {
+#if LIBPY_KERNELS_X86
+    switch (active) {
+    case k::target::avx512:
+        return avx512_clone<impl>(args...);
+    case k::target::avx2:
+        return avx2_clone<impl>(args...);
+    case k::target::baseline:
+        break;
+    }
+#endif
+    return impl(args...);
+}
+
+template<typename T, typename R, typename Op>
+void binary(const T *a,
+            py::ssize_t a_stride,
+            const T *b,
+            py::ssize_t b_stride,
+            R *out,
+            py::ssize_t len) {
+    if (a_stride == sizeof(T) && b_stride == sizeof(T)) {
+        dispatch<binary_contiguous<T, R, Op>>(a, b, out, len);
+    }
+    else {
+        binary_strided<T, R, Op>(a, a_stride, b, b_stride, out, len);
+    }
+}
+
+template<typename T>
+T extreme(const T *data, py::ssize_t len, py::ssize_t stride, bool is_max) {
+    if (stride == sizeof(T)) {
+        return is_max ? dispatch<extreme_contiguous<T, true>>(data, len) :
+                        dispatch<extreme_contiguous<T, false>>(data, len);
+    }
+    T out = data[0];
+    for (py::ssize_t ix = 0; ix < len; ++ix) {
+        T value = at(data, stride, ix);
+        if (is_nan(value)) {
+            return value;
+        }
+        if (is_max ? better<true>(value, out) : better<false>(value, out)) {
+            out = value;
+        }
+    }
+    return out;
+}
+
+template<typename T>
+py::ssize_t arg_extreme(const T *data,
+                        py::ssize_t len,
+                        py::ssize_t stride,
+                        bool is_max) {
+    if (stride == sizeof(T)) {
+        return is_max ?
+            dispatch<arg_extreme_contiguous<T, true>>(data, len) :
+            dispatch<arg_extreme_contiguous<T, false>>(data, len);
+    }
+    py::ssize_t out = 0;
+    for (py::ssize_t ix = 0; ix < len; ++ix) {
+        T value = at(data, stride, ix);
+        if (is_nan(value)) {
+            return ix;
+        }
+        if (is_max ? better<true>(value, at(data, stride, out)) :
+                     better<false>(value, at(data, stride, out))) {
+            out = ix;
+        }
+    }
+    return out;
+}
+
+template<typename T>
+constexpr char format_of = sizeof(T) == 1 ? '?' :
+                           std::is_floating_point<T>::value ?
+                               (sizeof(T) == 4 ? 'f' : 'd') :
+                               (sizeof(T) == 4 ? 'i' : 'q');
+}
+
+bool k::supported(k::target t) {
+    return t <= best_target;
+}
+
+k::target k::active_target() {
+    return active;
+}
+
+int k::set_target(k::target t) {
+    if (!supported(t)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "kernel target is not supported by this CPU");
+        return -1;
+    }
+    active = t;
+    return 0;
+}
+
+template<typename T>
+T k::sum(const T *data, py::ssize_t len, py::ssize_t stride) {
+    if (stride == sizeof(T)) {
+        return dispatch<sum_contiguous<T>>(data, len);
+    }
+    compensated<T> out;
+    for (py::ssize_t ix = 0; ix < len; ++ix) {
+        out.add(at(data, stride, ix));
+    }
+    return out.result();
+}
+
+template<typename T>
+T k::min(const T *data, py::ssize_t len, py::ssize_t stride) {
+    return extreme(data, len, stride, false);
+}
+
+template<typename T>
+T k::max(const T *data, py::ssize_t len, py::ssize_t stride) {
+    return extreme(data, len, stride, true);
+}
+
+template<typename T>
+py::ssize_t k::argmin(const T *data, py::ssize_t len, py::ssize_t stride) {
+    return arg_extreme(data, len, stride, false);
+}
+
+template<typename T>
+py::ssize_t k::argmax(const T *data, py::ssize_t len, py::ssize_t stride) {
+    return arg_extreme(data, len, stride, true);
+}
+
+template<typename T>
+T k::mean(const T *data, py::ssize_t len, py::ssize_t stride) {
+    return sum(data, len, stride) / len;
+}
+
+template<typename T>
+T k::variance(const T *data,
+              py::ssize_t len,
+              py::ssize_t stride,
+              py::ssize_t ddof) {
+    T center = mean(data, len, stride);
+    T total;
+    if (stride == sizeof(T)) {
+        total = dispatch<sum_squared_deviation_contiguous<T>>(data,
+                                                              len,
+                                                              center);
+    }
+    else {
+        compensated<T> acc;
+        squared_deviation<T> f{center};
+        for (py::ssize_t ix = 0; ix < len; ++ix) {
+            acc.add(f(at(data, stride, ix)));
+        }
+        total = acc.result();
+    }
+    return total / (len - ddof);
+}
+
+template<typename T>
+void k::add(const T *a,
+            py::ssize_t a_stride,
+            const T *b,
+            py::ssize_t b_stride,
+            T *out,
+            py::ssize_t len) {
+    binary<T, T, add_op<T>>(a, a_stride, b, b_stride, out, len);
+}
+
+template<typename T>
+void k::mul(const T *a,
+            py::ssize_t a_stride,
+            const T *b,
+            py::ssize_t b_stride,
+            T *out,
+            py::ssize_t len) {
+    binary<T, T, mul_op<T>>(a, a_stride, b, b_stride, out, len);
+}
+
+template<typename T>
+void k::compare(const T *a,
+                py::ssize_t a_stride,
+                const T *b,
+                py::ssize_t b_stride,
+                bool *out,
+                py::ssize_t len,
+                py::compareop op) {
+    switch (op) {
+    case py::LT:
+        binary<T, bool, std::less<T>>(a, a_stride, b, b_stride, out, len);
+        break;
+    case py::LE:
+        binary<T, bool, std::less_equal<T>>(a, a_stride, b, b_stride, out, len);
+        break;
+    case py::EQ:
+        binary<T, bool, std::equal_to<T>>(a, a_stride, b, b_stride, out, len);
+        break;
+    case py::NE:
+        binary<T, bool, std::not_equal_to<T>>(
+            a, a_stride, b, b_stride, out, len);
+        break;
+    case py::GT:
+        binary<T, bool, std::greater<T>>(a, a_stride, b, b_stride, out, len);
+        break;
+    case py::GE:
+        binary<T, bool, std::greater_equal<T>>(a,
+                                               a_stride,
+                                               b,
+                                               b_stride,
+                                               out,
+                                               len);
+        break;
+    }
+}
+
+template<typename T>
+py::tmpref<py::object> k::empty_like(const Py_buffer &like, T *&data) {
+    py::ssize_t len = 1;
+    for (int dim = 0; dim < like.ndim; ++dim) {
+        len *= like.shape[dim];
+    }
+
+    py::tmpref<py::object> bytes(
+        PyByteArray_FromStringAndSize(nullptr, len * sizeof(T)));
+    if (!bytes.is_nonnull()) {
+        return nullptr;
+    }
+    data = reinterpret_cast<T*>(PyByteArray_AS_STRING(
+                                    static_cast<PyObject*>(bytes)));
+
+    py::tmpref<py::object> view(PyMemoryView_FromObject(bytes));
+    if (!view.is_nonnull()) {
+        return nullptr;
+    }
+    const char format[] = {format_of<T>, '\0'};
+    if (!len) {
+        // `memoryview.cast` rejects shapes which contain a zero
+        return PyObject_CallMethod(view, "cast", "s", format);
+    }
+
+    py::tmpref<py::object> shape(PyTuple_New(like.ndim));
+    if (!shape.is_nonnull()) {
+        return nullptr;
+    }
+    for (int dim = 0; dim < like.ndim; ++dim) {
+        PyObject *size = PyLong_FromSsize_t(like.shape[dim]);
+        if (!size) {
+            return nullptr;
+        }
+        PyTuple_SET_ITEM(static_cast<PyObject*>(shape), dim, size);
+    }
+    return PyObject_CallMethod(view,
+                               "cast",
+                               "sO",
+                               format,
+                               static_cast<PyObject*>(shape));
+}
+
+#define LIBPY_INSTANTIATE_KERNELS(T)                                    \
+    template T k::sum<T>(const T*, py::ssize_t, py::ssize_t);           \
+    template T k::min<T>(const T*, py::ssize_t, py::ssize_t);           \
+    template T k::max<T>(const T*, py::ssize_t, py::ssize_t);           \
+    template py::ssize_t k::argmin<T>(const T*, py::ssize_t, py::ssize_t); \
+    template py::ssize_t k::argmax<T>(const T*, py::ssize_t, py::ssize_t); \
+    template void k::add<T>(const T*,                                   \
+                            py::ssize_t,                                \
+                            const T*,                                   \
+                            py::ssize_t,                                \
+                            T*,                                         \
+                            py::ssize_t);                               \
+    template void k::mul<T>(const T*,                                   \
+                            py::ssize_t,                                \
+                            const T*,                                   \
+                            py::ssize_t,                                \
+                            T*,                                         \
+                            py::ssize_t);                               \
+    template void k::compare<T>(const T*,                               \
+                                py::ssize_t,                            \
+                                const T*,                               \
+                                py::ssize_t,                            \
+                                bool*,                                  \
+                                py::ssize_t,                            \
+                                py::compareop);                         \
+    template py::tmpref<py::object> k::empty_like<T>(const Py_buffer&, T*&)
+
+LIBPY_INSTANTIATE_KERNELS(float);
+LIBPY_INSTANTIATE_KERNELS(double);
+LIBPY_INSTANTIATE_KERNELS(std::int32_t);
+LIBPY_INSTANTIATE_KERNELS(std::int64_t);
+
+template float k::mean<float>(const float*, py::ssize_t, py::ssize_t);
+template double k::mean<double>(const double*, py::ssize_t, py::ssize_t);
+template float k::variance<float>(const float*,
+                                  py::ssize_t,
+                                  py::ssize_t,
+                                  py::ssize_t);
+template double k::variance<double>(const double*,
+                                    py::ssize_t,
+                                    py::ssize_t,
+                                    py::ssize_t);
+template py::tmpref<py::object> k::empty_like<bool>(const Py_buffer&,
+                                                    bool*&);
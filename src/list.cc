@@ -1,8 +1,328 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+
 #include "libpy/list.h"
 #include "libpy/utils.h"
 
 namespace {
 namespace l = py::list;
+
+/**
+   Copy the items of an exact list or tuple into a new list, taking a new
+   reference to each.
+
+   Allocating the new list may run the garbage collector, and a `__del__`
+   can resize `seq`, so the source's items are only read once `out` exists.
+*/
+py::tmpref<l::object> copy_items(PyObject *seq) {
+    PyObject *out = PyList_New(PySequence_Fast_GET_SIZE(seq));
+    if (!out) {
+        return nullptr;
+    }
+    py::ssize_t len = std::min(PySequence_Fast_GET_SIZE(seq), Py_SIZE(out));
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    PyObject **dst = reinterpret_cast<PyListObject*>(out)->ob_item;
+    for (py::ssize_t ix = 0; ix < len; ++ix) {
+        Py_INCREF(items[ix]);
+        dst[ix] = items[ix];
+    }
+    // a list which shrank leaves the trailing slots null
+#if PY_VERSION_HEX >= 0x030900A4
+    Py_SET_SIZE(out, len);
+#else
+    Py_SIZE(out) = len;
+#endif
+    return out;
+}
+
+/**
+   Lists of integers with at least this many elements are radix sorted.
+*/
+constexpr py::ssize_t radix_sort_threshold = 1 << 10;
+
+/**
+   A list element paired with its unboxed sort key.
+*/
+template<typename K>
+struct keyed {
+    K key;
+    PyObject *ob;
+
+    inline bool operator<(const keyed &other) const {
+        return key < other.key;
+    }
+};
+
+/**
+   Compare two ready `str`s by code point, which is the order used by
+   `str.__lt__`.
+*/
+bool str_less(PyObject *a, PyObject *b) {
+    py::ssize_t alen = PyUnicode_GET_LENGTH(a);
+    py::ssize_t blen = PyUnicode_GET_LENGTH(b);
+    py::ssize_t len = std::min(alen, blen);
+    int akind = PyUnicode_KIND(a);
+    int bkind = PyUnicode_KIND(b);
+    const void *adata = PyUnicode_DATA(a);
+    const void *bdata = PyUnicode_DATA(b);
+
+    if (akind == PyUnicode_1BYTE_KIND && bkind == PyUnicode_1BYTE_KIND) {
+        int cmp = std::memcmp(adata, bdata, len);
+        return cmp ? cmp < 0 : alen < blen;
+    }
+    for (py::ssize_t ix = 0; ix < len; ++ix) {
+        Py_UCS4 ac = PyUnicode_READ(akind, adata, ix);
+        Py_UCS4 bc = PyUnicode_READ(bkind, bdata, ix);
+        if (ac != bc) {
+            return ac < bc;
+        }
+    }
+    return alen < blen;
+}
+
+struct str_key {
+    PyObject *ob;
+
+    inline bool operator<(const str_key &other) const {
+        return str_less(ob, other.ob);
+    }
+};
+
+/**
+   Stable LSD radix sort on the 64 bit keys, one byte per pass. Passes
+   where every key has the same digit are skipped, so lists of small
+   integers only need one or two passes.
+
+   This does not allocate so that it may run on a worker thread; `scratch`
+   must have room for `last - first` elements.
+*/
+void radix_sort(keyed<std::int64_t> *first,
+                keyed<std::int64_t> *last,
+                keyed<std::int64_t> *scratch) {
+    std::size_t len = last - first;
+    std::array<std::array<std::size_t, 256>, 8> counts{};
+
+    // flip the sign bit so that the unsigned order matches the signed order
+    auto digits = [](std::int64_t key) {
+        return static_cast<std::uint64_t>(key) ^ (std::uint64_t(1) << 63);
+    };
+    for (auto it = first; it != last; ++it) {
+        std::uint64_t u = digits(it->key);
+        for (int byte = 0; byte < 8; ++byte) {
+            ++counts[byte][(u >> (8 * byte)) & 0xff];
+        }
+    }
+
+    keyed<std::int64_t> *src = first;
+    keyed<std::int64_t> *dst = scratch;
+    for (int byte = 0; byte < 8; ++byte) {
+        auto &count = counts[byte];
+        int shift = 8 * byte;
+        if (count[(digits(src->key) >> shift) & 0xff] == len) {
+            continue;
+        }
+        std::size_t offset = 0;
+        for (auto &c : count) {
+            std::size_t n = c;
+            c = offset;
+            offset += n;
+        }
+        for (std::size_t ix = 0; ix < len; ++ix) {
+            dst[count[(digits(src[ix].key) >> shift) & 0xff]++] = src[ix];
+        }
+        std::swap(src, dst);
+    }
+    if (src != first) {
+        std::copy(src, src + len, first);
+    }
+}
+
+/**
+   Sort a chunk of keys. `scratch` is the buffer for `radix_sort` or
+   `nullptr` to always use `std::stable_sort`, which falls back to an
+   in place algorithm instead of throwing when it cannot allocate.
+*/
+template<typename T>
+void serial_sort(T *first, T *last, T *scratch) {
+    if constexpr (std::is_same<T, keyed<std::int64_t>>::value) {
+        if (scratch && last - first >= radix_sort_threshold) {
+            radix_sort(first, last, scratch);
+            return;
+        }
+    }
+    std::stable_sort(first, last);
+}
+
+/**
+   Sort `keys` on up to `nthreads` threads by stably sorting contiguous
+   chunks and then merging neighbouring chunks.
+*/
+template<typename T>
+void parallel_sort(std::vector<T> &keys, unsigned nthreads) {
+    std::size_t len = keys.size();
+
+    // everything is allocated on the calling thread, where a `bad_alloc`
+    // becomes a `MemoryError`; in a worker it would terminate the process
+    std::vector<T> scratch;
+    if constexpr (std::is_same<T, keyed<std::int64_t>>::value) {
+        if (len >= static_cast<std::size_t>(radix_sort_threshold)) {
+            scratch.resize(len);
+        }
+    }
+    auto scratch_at = [&](std::size_t ix) {
+        return scratch.empty() ? nullptr : scratch.data() + ix;
+    };
+
+    if (nthreads <= 1 ||
+        len < static_cast<std::size_t>(l::parallel_sort_threshold)) {
+        serial_sort(keys.data(), keys.data() + len, scratch_at(0));
+        return;
+    }
+
+    std::vector<std::size_t> bounds;
+    for (unsigned n = 0; n <= nthreads; ++n) {
+        bounds.push_back(len * n / nthreads);
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(nthreads);
+    for (unsigned n = 0; n < nthreads; ++n) {
+        T *first = keys.data() + bounds[n];
+        T *last = keys.data() + bounds[n + 1];
+        try {
+            threads.emplace_back(serial_sort<T>,
+                                 first,
+                                 last,
+                                 scratch_at(bounds[n]));
+        }
+        catch (const std::system_error&) {
+            serial_sort(first, last, scratch_at(bounds[n]));
+        }
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // merging neighbours keeps equal elements in their original order
+    for (std::size_t width = 1; width < nthreads; width *= 2) {
+        for (std::size_t n = 0; n + width < nthreads; n += 2 * width) {
+            std::inplace_merge(
+                keys.data() + bounds[n],
+                keys.data() + bounds[n + width],
+                keys.data() + bounds[std::min<std::size_t>(n + 2 * width,
+                                                           nthreads)]);
+        }
+    }
+}
+
+/**
+   Sort `keys` and write the objects back into `items` in order.
+*/
+template<typename T>
+void sort_and_permute(std::vector<T> &keys,
+                      PyObject **items,
+                      unsigned nthreads) {
+    parallel_sort(keys, nthreads);
+    for (std::size_t ix = 0; ix < keys.size(); ++ix) {
+        items[ix] = keys[ix].ob;
+    }
+}
+
+/**
+   Try to sort a list without rich comparisons.
+
+   @return 1 if the list was sorted, 0 if the list is not homogeneous and
+           must be sorted with `list.sort`, or -1 on failure.
+*/
+int try_sort_native(PyObject *list, unsigned nthreads) {
+    py::ssize_t len = PyList_GET_SIZE(list);
+    PyObject **items = reinterpret_cast<PyListObject*>(list)->ob_item;
+    if (len < 2) {
+        return 1;
+    }
+
+    PyTypeObject *type = Py_TYPE(items[0]);
+    for (py::ssize_t ix = 1; ix < len; ++ix) {
+        if (Py_TYPE(items[ix]) != type) {
+            return 0;
+        }
+    }
+
+    if (type == &PyFloat_Type) {
+        std::vector<keyed<double>> keys(len);
+        for (py::ssize_t ix = 0; ix < len; ++ix) {
+            double key = PyFloat_AS_DOUBLE(items[ix]);
+            if (std::isnan(key)) {
+                // nan is unordered so `list.sort` does not produce a
+                // sorted result; leave its exact behavior to `list.sort`
+                return 0;
+            }
+            keys[ix] = {key, items[ix]};
+        }
+        sort_and_permute(keys, items, nthreads);
+        return 1;
+    }
+    if (type == &PyLong_Type) {
+        std::vector<keyed<std::int64_t>> keys(len);
+        for (py::ssize_t ix = 0; ix < len; ++ix) {
+            long long key;
+            if (!py::read_small_int(items[ix], key)) {
+                int overflow;
+                key = PyLong_AsLongLongAndOverflow(items[ix], &overflow);
+                if (overflow) {
+                    return 0;
+                }
+            }
+            keys[ix] = {key, items[ix]};
+        }
+        sort_and_permute(keys, items, nthreads);
+        return 1;
+    }
+    if (type == &PyUnicode_Type) {
+        std::vector<str_key> keys(len);
+        for (py::ssize_t ix = 0; ix < len; ++ix) {
+#if PY_VERSION_HEX < 0x030C0000
+            if (PyUnicode_READY(items[ix])) {
+                return -1;
+            }
+#endif
+            keys[ix] = {items[ix]};
+        }
+        sort_and_permute(keys, items, nthreads);
+        return 1;
+    }
+    return 0;
+}
+
+int sort_native_impl(const l::object &ob, unsigned nthreads) {
+    if (!ob.is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+
+    int status;
+    try {
+        status = try_sort_native(ob, nthreads);
+    }
+    catch (const std::bad_alloc&) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    if (status < 0) {
+        return -1;
+    }
+    if (!status) {
+        return PyList_Sort(ob);
+    }
+    return 0;
+}
 }
 
 const py::type::object<l::object> l::type(&PyList_Type);
@@ -98,6 +418,68 @@ py::object l::object::operator[](std::size_t idx) const {
     return PyList_GET_ITEM(ob, idx);
 }
 
+int l::object::reserve(py::ssize_t capacity) const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+
+    PyListObject *l = reinterpret_cast<PyListObject*>(ob);
+    if (capacity <= l->allocated) {
+        return 0;
+    }
+    if (static_cast<std::size_t>(capacity) >
+        PY_SSIZE_T_MAX / sizeof(PyObject*)) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    // list storage is owned by the PyMem allocator; resize it in place the
+    // same way `list.extend` does
+    PyObject **items = static_cast<PyObject**>(
+        PyMem_Realloc(l->ob_item, capacity * sizeof(PyObject*)));
+    if (!items) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    l->ob_item = items;
+    l->allocated = capacity;
+    return 0;
+}
+
+void l::object::set_len(py::ssize_t len) const {
+#if PY_VERSION_HEX >= 0x030900A4
+    Py_SET_SIZE(ob, len);
+#else
+    Py_SIZE(ob) = len;
+#endif
+}
+
+py::item_span l::object::slice(py::ssize_t start,
+                                 py::ssize_t stop,
+                                 py::ssize_t step) const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return item_span();
+    }
+    return make_item_span(reinterpret_cast<PyListObject*>(ob)->ob_item,
+                          PyList_GET_SIZE(ob),
+                          start,
+                          stop,
+                          step);
+}
+
+py::tmpref<l::object> l::object::slice_copy(py::ssize_t start,
+                                                py::ssize_t stop,
+                                                py::ssize_t step) const {
+    item_span span = slice(start, stop, step);
+    if (!span.is_nonnull()) {
+        return nullptr;
+    }
+    auto out = span.to_list();
+    PyObject *pob = out;
+    std::move(out).invalidate();
+    return pob;
+}
 
 py::nonnull<l::object> l::object::as_nonnull() const {
     if (!is_nonnull()) {
@@ -112,3 +494,60 @@ py::tmpref<l::object> l::object::as_tmpref() && {
     ob = nullptr;
     return ret;
 }
+
+py::tmpref<l::object> l::_from_py_iterable(const py::object &seq) {
+    PyObject *pob = seq;
+
+    if (PyList_CheckExact(pob) || PyTuple_CheckExact(pob)) {
+        return copy_items(pob);
+    }
+
+    py::ssize_t hint = seq.lenhint(0);
+    if (hint < 0) {
+        return nullptr;
+    }
+    py::tmpref<py::object> it(PyObject_GetIter(pob));
+    if (!it.is_nonnull()) {
+        return nullptr;
+    }
+    py::tmpref<l::object> out(hint);
+    if (!out.is_nonnull()) {
+        return nullptr;
+    }
+
+    // fill the preallocated slots, then append which lets the list grow
+    // geometrically if the hint was too small
+    py::ssize_t len = 0;
+    PyObject *item;
+    while ((item = PyIter_Next(it))) {
+        if (len < hint) {
+            PyList_SET_ITEM(static_cast<PyObject*>(out), len, item);
+        }
+        else {
+            int err = PyList_Append(out, item);
+            Py_DECREF(item);
+            if (err) {
+                return nullptr;
+            }
+        }
+        ++len;
+    }
+    if (PyErr_Occurred()) {
+        return nullptr;
+    }
+    if (len < hint && PyList_SetSlice(out, len, hint, nullptr)) {
+        return nullptr;
+    }
+    return out;
+}
+
+int l::sort_native(const l::object &ob) {
+    return sort_native_impl(ob, 1);
+}
+
+int l::sort_native_parallel(const l::object &ob, unsigned nthreads) {
+    if (!nthreads) {
+        nthreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    return sort_native_impl(ob, nthreads);
+}
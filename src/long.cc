@@ -13,7 +13,7 @@ const py::long_::object &py::operator""_p(unsigned long long l) {
     return ob;
 }
 
-const py::type::object<py::long_::object> py::long_::type(&PyList_Type);
+const py::type::object<py::long_::object> py::long_::type(&PyLong_Type);
 
 py::long_::object::object() : py::object(nullptr) {}
 
@@ -80,6 +80,74 @@ double py::long_::object::as_double() const {
     return as_t<double, PyLong_AsDouble>();
 }
 
+#ifdef __SIZEOF_INT128__
+__int128 py::long_::object::as_int128() const {
+    __int128 out;
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return py::unbox(ob, out) ? -1 : out;
+}
+
+unsigned __int128 py::long_::object::as_uint128() const {
+    unsigned __int128 out;
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return py::unbox(ob, out) ? -1 : out;
+}
+
+py::tmpref<py::long_::object> py::long_::from_int128(__int128 value) {
+    return py::box(value);
+}
+
+py::tmpref<py::long_::object>
+py::long_::from_uint128(unsigned __int128 value) {
+    return py::box(value);
+}
+#endif
+
+py::ssize_t py::long_::object::byte_length(bool is_signed) const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    std::size_t bits = _PyLong_NumBits(ob);
+    if (bits == static_cast<std::size_t>(-1) && PyErr_Occurred()) {
+        return -1;
+    }
+    if (is_signed) {
+        // `_PyLong_NumBits` counts the magnitude; one more bit holds the
+        // sign
+        bits += 1;
+    }
+    return (bits + 7) / 8;
+}
+
+int py::long_::object::to_bytes(unsigned char *out,
+                                std::size_t len,
+                                bool little_endian,
+                                bool is_signed) const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return py::detail::_long_as_byte_array(ob,
+                                           out,
+                                           len,
+                                           little_endian,
+                                           is_signed);
+}
+
+py::tmpref<py::long_::object> py::long_::from_bytes(const unsigned char *data,
+                                                    std::size_t len,
+                                                    bool little_endian,
+                                                    bool is_signed) {
+    return _PyLong_FromByteArray(data, len, little_endian, is_signed);
+}
+
 py::nonnull<py::long_::object> py::long_::object::as_nonnull() const {
     if (!is_nonnull()) {
         throw pyutils::bad_nonnull();
@@ -94,6 +162,10 @@ py::tmpref<py::long_::object> py::long_::object::as_tmpref() && {
 }
 
 py::tmpref<py::long_::object> py::long_::object::operator-() const {
+    long long value;
+    if (small_exact(value)) {
+        return PyLong_FromLongLong(-value);
+    }
     return ob_unary_func<PyNumber_Negative>();
 }
 
@@ -102,9 +174,17 @@ py::tmpref<py::long_::object> py::long_::object::operator+() const {
 }
 
 py::tmpref<py::long_::object> py::long_::object::abs() const {
+    long long value;
+    if (small_exact(value)) {
+        return PyLong_FromLongLong(value < 0 ? -value : value);
+    }
     return ob_unary_func<PyNumber_Absolute>();
 }
 
 py::tmpref<py::long_::object> py::long_::object::invert() const {
+    long long value;
+    if (small_exact(value)) {
+        return PyLong_FromLongLong(~value);
+    }
     return ob_unary_func<PyNumber_Invert>();
 }
@@ -2,6 +2,7 @@
 #include <utility>
 
 #include "libpy/object.h"
+#include "libpy/str.h"
 
 const py::object py::None = Py_None;
 const py::object py::NotImplemented = Py_NotImplemented;
@@ -59,16 +60,15 @@ const py::object &py::operator""_p(const wchar_t *cs, std::size_t len) {
     return ob;
 }
 
-const py::object &py::operator""_p(long double d) {
-    static std::unordered_map<long double, py::object> cache;
-    py::object &ob = cache[d];
-    if (!ob.is_nonnull()) {
-        ob.ob = PyFloat_FromDouble(d);
+std::ostream &py::operator<<(std::ostream &stream, const py::object &ob) {
+    if (ob.is_nonnull() && PyUnicode_CheckExact(static_cast<PyObject*>(ob))) {
+        // `str(ob)` would be `ob`, write the cached utf-8 directly
+        std::string_view cs = py::str::object(ob).as_string_view();
+        if (cs.data()) {
+            return stream.write(cs.data(), cs.size());
+        }
     }
-    return ob;
-}
 
-std::ostream &py::operator<<(std::ostream &stream, const py::object &ob) {
     /* We can avoid the null check because this happens in PyUnicode_AsUTF8.
        When ob is nullptr the result is "<NULL>". */
     return stream << PyUnicode_AsUTF8(ob.str());
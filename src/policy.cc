@@ -0,0 +1,47 @@
+#include "libpy/policy.h"
+
+py::error_already_set::error_already_set() {
+    PyErr_Fetch(&type, &value, &tb);
+    if (!type) {
+        PyErr_SetString(PyExc_SystemError,
+                        "error_already_set without a Python exception");
+        PyErr_Fetch(&type, &value, &tb);
+    }
+}
+
+py::error_already_set::error_already_set(const error_already_set &cpfrom)
+    : std::exception(cpfrom),
+      type(cpfrom.type),
+      value(cpfrom.value),
+      tb(cpfrom.tb) {
+    Py_XINCREF(type);
+    Py_XINCREF(value);
+    Py_XINCREF(tb);
+}
+
+py::error_already_set::error_already_set(error_already_set &&mvfrom) noexcept
+    : std::exception(mvfrom),
+      type(mvfrom.type),
+      value(mvfrom.value),
+      tb(mvfrom.tb) {
+    mvfrom.type = mvfrom.value = mvfrom.tb = nullptr;
+}
+
+py::error_already_set::~error_already_set() {
+    Py_XDECREF(type);
+    Py_XDECREF(value);
+    Py_XDECREF(tb);
+}
+
+void py::error_already_set::restore() {
+    PyErr_Restore(type, value, tb);
+    type = value = tb = nullptr;
+}
+
+bool py::error_already_set::matches(const py::object &exc) const {
+    return type && PyErr_GivenExceptionMatches(type, exc);
+}
+
+const char *py::error_already_set::what() const noexcept {
+    return "a Python exception was raised";
+}
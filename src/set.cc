@@ -0,0 +1,120 @@
+#include "libpy/set.h"
+#include "libpy/utils.h"
+
+namespace {
+namespace s = py::set;
+}
+
+const py::type::object<s::object> s::type(&PySet_Type);
+const py::type::object<s::object> s::frozenset_type(&PyFrozenSet_Type);
+
+s::object::object() : py::object() {}
+
+s::object::object(PyObject *pob) : py::object(pob) {
+    set_check();
+}
+
+s::object::object(const py::object &pob) : py::object(pob) {
+    set_check();
+}
+
+s::object::object(const s::object &cpfrom) : py::object(cpfrom.ob) {}
+
+s::object::object(s::object &&mvfrom) noexcept : py::object(mvfrom.ob) {
+    mvfrom.ob = nullptr;
+}
+
+void s::object::set_check() {
+    if (ob && !PyAnySet_Check(ob)) {
+        ob = nullptr;
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError,
+                            "cannot make py::set::object from non set");
+        }
+    }
+}
+
+s::object::const_iterator s::object::cbegin() const {
+    // a null set produces the end marker
+    return s::const_iterator(ob);
+}
+
+s::object::const_iterator s::object::cend() const {
+    return s::const_iterator();
+}
+
+s::object::iterator s::object::begin() const {
+    return cbegin();
+}
+
+s::object::iterator s::object::end() const {
+    return cend();
+}
+
+py::ssize_t s::object::len() const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PySet_GET_SIZE(ob);
+}
+
+int s::object::contains(const py::object &key) const {
+    if (!pyutils::all_nonnull(*this, key)) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PySet_Contains(ob, key);
+}
+
+int s::object::add(const py::object &key) const {
+    if (!pyutils::all_nonnull(*this, key)) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PySet_Add(ob, key);
+}
+
+int s::object::discard(const py::object &key) const {
+    if (!pyutils::all_nonnull(*this, key)) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    return PySet_Discard(ob, key);
+}
+
+int s::object::update(const py::list::object &l) const {
+    if (!pyutils::all_nonnull(*this, l)) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+
+    // the elements of a list are never null, so we can skip the checks
+    // that the generic range overload does. Hashing or comparing an element
+    // may run code which changes the list, so the size is read again each
+    // iteration and the element is kept alive while it is added.
+    PyObject *list = l;
+    for (py::ssize_t ix = 0; ix < PyList_GET_SIZE(list); ++ix) {
+        PyObject *elem = PyList_GET_ITEM(list, ix);
+        Py_INCREF(elem);
+        int status = PySet_Add(ob, elem);
+        Py_DECREF(elem);
+        if (status) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+py::nonnull<s::object> s::object::as_nonnull() const {
+    if (!is_nonnull()) {
+        throw pyutils::bad_nonnull();
+    }
+    return nonnull<s::object>(ob);
+}
+
+py::tmpref<s::object> s::object::as_tmpref() && {
+    tmpref<s::object> ret(ob);
+    ob = nullptr;
+    return ret;
+}
@@ -0,0 +1,78 @@
+#include "libpy/slice.h"
+
+py::item_span py::make_item_span(PyObject *const *items,
+                                 py::ssize_t len,
+                                 py::ssize_t start,
+                                 py::ssize_t stop,
+                                 py::ssize_t step) {
+    if (!step) {
+        PyErr_SetString(PyExc_ValueError, "slice step cannot be zero");
+        return item_span();
+    }
+    if (stop == slice_end && step < 0) {
+        // an omitted stop with a negative step runs to the front
+        stop = PY_SSIZE_T_MIN;
+    }
+
+    // clamp the bounds like `PySlice_AdjustIndices`, which is not
+    // available before Python 3.6.1
+    if (start < 0) {
+        start += len;
+        if (start < 0) {
+            start = (step < 0) ? -1 : 0;
+        }
+    }
+    else if (start >= len) {
+        start = (step < 0) ? len - 1 : len;
+    }
+    if (stop < 0) {
+        stop += len;
+        if (stop < 0) {
+            stop = (step < 0) ? -1 : 0;
+        }
+    }
+    else if (stop >= len) {
+        stop = (step < 0) ? len - 1 : len;
+    }
+
+    py::ssize_t count = 0;
+    if (step < 0) {
+        if (stop < start) {
+            count = (start - stop - 1) / -step + 1;
+        }
+    }
+    else if (start < stop) {
+        count = (stop - start - 1) / step + 1;
+    }
+    if (!count) {
+        // `start` may be -1 and the items of an empty list may be null
+        return item_span(items, 0, step);
+    }
+    return item_span(items + start, count, step);
+}
+
+py::tmpref<py::object> py::item_span::to_tuple() const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return nullptr;
+    }
+    PyObject *out = PyTuple_New(len);
+    if (!out) {
+        return nullptr;
+    }
+    copy_to(reinterpret_cast<PyTupleObject*>(out)->ob_item);
+    return out;
+}
+
+py::tmpref<py::object> py::item_span::to_list() const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return nullptr;
+    }
+    PyObject *out = PyList_New(len);
+    if (!out) {
+        return nullptr;
+    }
+    copy_to(reinterpret_cast<PyListObject*>(out)->ob_item);
+    return out;
+}
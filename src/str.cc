@@ -0,0 +1,83 @@
+#include "libpy/str.h"
+#include "libpy/utils.h"
+
+namespace {
+namespace s = py::str;
+}
+
+const py::type::object<s::object> s::type(&PyUnicode_Type);
+
+s::object::object() : py::object() {}
+
+s::object::object(PyObject *pob) : py::object(pob) {
+    str_check();
+}
+
+s::object::object(const py::object &pob) : py::object(pob) {
+    str_check();
+}
+
+s::object::object(std::string_view cs)
+    : py::object(PyUnicode_FromStringAndSize(cs.data(), cs.size())) {}
+
+s::object::object(const s::object &cpfrom) : py::object(cpfrom.ob) {}
+
+s::object::object(s::object &&mvfrom) noexcept : py::object(mvfrom.ob) {
+    mvfrom.ob = nullptr;
+}
+
+void s::object::str_check() {
+    if (ob && !PyUnicode_Check(ob)) {
+        ob = nullptr;
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError,
+                            "cannot make py::str::object from non str");
+        }
+    }
+}
+
+py::ssize_t s::object::len() const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    if (ready()) {
+        return -1;
+    }
+    return PyUnicode_GET_LENGTH(ob);
+}
+
+std::string_view s::object::as_string_view() const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return {};
+    }
+
+    py::ssize_t size;
+    const char *cs = PyUnicode_AsUTF8AndSize(ob, &size);
+    if (!cs) {
+        return {};
+    }
+    return {cs, static_cast<std::size_t>(size)};
+}
+
+s::kind s::object::kind() const {
+    if (!is_nonnull() || ready()) {
+        pyutils::failed_null_check();
+        return s::kind::ucs1;
+    }
+    return static_cast<s::kind>(PyUnicode_KIND(ob));
+}
+
+py::nonnull<s::object> s::object::as_nonnull() const {
+    if (!is_nonnull()) {
+        throw pyutils::bad_nonnull();
+    }
+    return nonnull<s::object>(ob);
+}
+
+py::tmpref<s::object> s::object::as_tmpref() && {
+    tmpref<s::object> ret(ob);
+    ob = nullptr;
+    return ret;
+}
@@ -0,0 +1,102 @@
+#include <cstdio>
+#include <cstring>
+
+#include "libpy/str_writer.h"
+
+py::str_writer::str_writer(py::ssize_t capacity) : failed(false) {
+    _PyUnicodeWriter_Init(&writer);
+    // strings are built a piece at a time, so grow the buffer geometrically
+    writer.overallocate = 1;
+    writer.min_length = capacity;
+}
+
+py::str_writer::str_writer(str_writer &&mvfrom) noexcept
+    : writer(mvfrom.writer), failed(mvfrom.failed) {
+    // the writer only points at its buffer object, not into itself, so it
+    // may be moved by copying it
+    _PyUnicodeWriter_Init(&mvfrom.writer);
+    mvfrom.writer.overallocate = 1;
+    mvfrom.failed = false;
+}
+
+py::str_writer::~str_writer() {
+    _PyUnicodeWriter_Dealloc(&writer);
+}
+
+int py::str_writer::write(std::string_view cs) {
+    if (failed) {
+        return -1;
+    }
+    for (unsigned char c : cs) {
+        if (c >= 0x80) {
+            tmpref<py::object> decoded(PyUnicode_DecodeUTF8(cs.data(),
+                                                            cs.size(),
+                                                            nullptr));
+            if (!decoded.is_nonnull()) {
+                failed = true;
+                return -1;
+            }
+            return check(_PyUnicodeWriter_WriteStr(&writer, decoded));
+        }
+    }
+    return check(_PyUnicodeWriter_WriteASCIIString(&writer,
+                                                   cs.data(),
+                                                   cs.size()));
+}
+
+int py::str_writer::put(Py_UCS4 c) {
+    if (failed) {
+        return -1;
+    }
+    return check(_PyUnicodeWriter_WriteChar(&writer, c));
+}
+
+int py::str_writer::write(const py::object &ob) {
+    if (failed) {
+        return -1;
+    }
+    if (ob.is_nonnull() && PyUnicode_CheckExact(static_cast<PyObject*>(ob))) {
+        return check(_PyUnicodeWriter_WriteStr(&writer, ob));
+    }
+    // this writes "<NULL>" for `nullptr` like `operator<<(std::ostream&)`
+    tmpref<py::object> s(PyObject_Str(ob));
+    if (!s.is_nonnull()) {
+        failed = true;
+        return -1;
+    }
+    return check(_PyUnicodeWriter_WriteStr(&writer, s));
+}
+
+int py::str_writer::write_integer(long long value) {
+    char buf[32];
+    int len = std::snprintf(buf, sizeof(buf), "%lld", value);
+    return check(_PyUnicodeWriter_WriteASCIIString(&writer, buf, len));
+}
+
+int py::str_writer::write_integer(unsigned long long value) {
+    char buf[32];
+    int len = std::snprintf(buf, sizeof(buf), "%llu", value);
+    return check(_PyUnicodeWriter_WriteASCIIString(&writer, buf, len));
+}
+
+int py::str_writer::write_floating(long double value) {
+    // "%Lg" matches the default formatting of `std::ostream`
+    char buf[64];
+    int len = std::snprintf(buf, sizeof(buf), "%Lg", value);
+    return check(_PyUnicodeWriter_WriteASCIIString(&writer, buf, len));
+}
+
+py::tmpref<py::object> py::str_writer::finalize() {
+    if (failed) {
+        _PyUnicodeWriter_Dealloc(&writer);
+        _PyUnicodeWriter_Init(&writer);
+        writer.overallocate = 1;
+        failed = false;
+        pyutils::failed_null_check();
+        return nullptr;
+    }
+    PyObject *out = _PyUnicodeWriter_Finish(&writer);
+    _PyUnicodeWriter_Init(&writer);
+    writer.overallocate = 1;
+    return out;
+}
@@ -97,6 +97,54 @@ py::object t::object::operator[](std::size_t idx) const {
 }
 
 
+py::item_span t::object::slice(py::ssize_t start,
+                                 py::ssize_t stop,
+                                 py::ssize_t step) const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return item_span();
+    }
+    return make_item_span(reinterpret_cast<PyTupleObject*>(ob)->ob_item,
+                          PyTuple_GET_SIZE(ob),
+                          start,
+                          stop,
+                          step);
+}
+
+py::tmpref<t::object> t::object::slice_copy(py::ssize_t start,
+                                                py::ssize_t stop,
+                                                py::ssize_t step) const {
+    item_span span = slice(start, stop, step);
+    if (!span.is_nonnull()) {
+        return nullptr;
+    }
+    if (span.size() == PyTuple_GET_SIZE(ob) && step == 1 &&
+        PyTuple_CheckExact(ob)) {
+        // tuples are immutable so a full slice may share the tuple
+        Py_INCREF(ob);
+        return ob;
+    }
+    auto out = span.to_tuple();
+    PyObject *pob = out;
+    std::move(out).invalidate();
+    return pob;
+}
+
+int t::object::check_arity(py::ssize_t len) const {
+    if (!is_nonnull()) {
+        pyutils::failed_null_check();
+        return -1;
+    }
+    if (PyTuple_GET_SIZE(ob) != len) {
+        PyErr_Format(PyExc_ValueError,
+                     "expected a tuple of length %zd, got %zd",
+                     len,
+                     PyTuple_GET_SIZE(ob));
+        return -1;
+    }
+    return 0;
+}
+
 py::nonnull<t::object> t::object::as_nonnull() const {
     if (!is_nonnull()) {
         throw pyutils::bad_nonnull();
@@ -110,3 +158,61 @@ py::tmpref<t::object> t::object::as_tmpref() && {
     ob = nullptr;
     return ret;
 }
+
+py::tmpref<t::object> t::_from_py_iterable(const py::object &seq) {
+    PyObject *pob = seq;
+
+    if (PyTuple_CheckExact(pob)) {
+        // tuples are immutable so we can share the input
+        Py_INCREF(pob);
+        return pob;
+    }
+    if (PyList_CheckExact(pob)) {
+        return PyList_AsTuple(pob);
+    }
+
+    py::ssize_t hint = seq.lenhint(8);
+    if (hint < 0) {
+        return nullptr;
+    }
+    py::tmpref<py::object> it(PyObject_GetIter(pob));
+    if (!it.is_nonnull()) {
+        return nullptr;
+    }
+    // never start from the shared empty tuple, it cannot be resized
+    py::ssize_t capacity = hint ? hint : 8;
+    PyObject *out = PyTuple_New(capacity);
+    if (!out) {
+        return nullptr;
+    }
+
+    // `_PyTuple_Resize` releases the tuple and sets `out` to `nullptr` on
+    // failure
+    py::ssize_t len = 0;
+    PyObject *item;
+    while ((item = PyIter_Next(it))) {
+        if (len == capacity) {
+            // the same growth policy as `tuple(iterable)`
+            py::ssize_t new_capacity = capacity + 10 + (capacity >> 2);
+            if (new_capacity < capacity) {
+                PyErr_NoMemory();
+            }
+            if (new_capacity < capacity ||
+                _PyTuple_Resize(&out, new_capacity)) {
+                Py_DECREF(item);
+                Py_XDECREF(out);
+                return nullptr;
+            }
+            capacity = new_capacity;
+        }
+        PyTuple_SET_ITEM(out, len++, item);
+    }
+    if (PyErr_Occurred()) {
+        Py_DECREF(out);
+        return nullptr;
+    }
+    if (len != capacity && _PyTuple_Resize(&out, len)) {
+        return nullptr;
+    }
+    return out;
+}
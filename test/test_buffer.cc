@@ -0,0 +1,205 @@
+#include <array>
+#include <cstring>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include <Python.h>
+
+#include "libpy/automethod.h"
+#include "libpy/libpy.h"
+#include "utils.h"
+
+using py::operator""_p;
+
+namespace {
+/**
+   Create a `memoryview` of `count` doubles `0, 1, ..., count - 1` cast to
+   the given shape.
+*/
+py::tmpref<py::object> doubles(py::ssize_t count, py::object shape) {
+    py::tmpref<py::object> bytes(
+        PyByteArray_FromStringAndSize(nullptr, count * sizeof(double)));
+    if (!bytes.is_nonnull()) {
+        return nullptr;
+    }
+    double *data = reinterpret_cast<double*>(
+        PyByteArray_AS_STRING(static_cast<PyObject*>(bytes)));
+    for (py::ssize_t n = 0; n < count; ++n) {
+        data[n] = n;
+    }
+    py::tmpref<py::object> view(PyMemoryView_FromObject(bytes));
+    if (!view.is_nonnull()) {
+        return nullptr;
+    }
+    return PyObject_CallMethod(view, "cast", "sO", "d",
+                               static_cast<PyObject*>(shape));
+}
+}
+
+TEST(BufferView, bytearray) {
+    py::tmpref<py::object> bytes(PyByteArray_FromStringAndSize("abc", 3));
+    ASSERT_NONNULL(bytes);
+
+    {
+        py::buffer_view<unsigned char> view(bytes);
+        ASSERT_TRUE(view.is_nonnull());
+        EXPECT_IS(view.owner(), bytes);
+        EXPECT_EQ(view.size(), 3);
+        EXPECT_EQ(view.shape(), 3);
+        EXPECT_TRUE(view.is_contiguous());
+        EXPECT_EQ(view[0], 'a');
+        EXPECT_EQ(view.data()[2], 'c');
+
+        view[1] = 'z';
+        // resizing is not allowed while the buffer is exported
+        EXPECT_NE(PyByteArray_Resize(bytes, 10), 0);
+        EXPECT_PYTHON_ERR(PyExc_BufferError);
+    }
+
+    EXPECT_EQ(std::strcmp(PyByteArray_AS_STRING(static_cast<PyObject*>(bytes)),
+                          "azc"), 0);
+    // the view released the buffer
+    EXPECT_EQ(PyByteArray_Resize(bytes, 10), 0);
+}
+
+TEST(BufferView, readonly) {
+    py::tmpref<py::object> bytes(PyBytes_FromString("abc"));
+    ASSERT_NONNULL(bytes);
+
+    py::buffer_view<const unsigned char> view(bytes);
+    ASSERT_TRUE(view.is_nonnull());
+    EXPECT_EQ(view[2], 'c');
+
+    py::buffer_view<unsigned char> writable(bytes);
+    EXPECT_FALSE(writable.is_nonnull());
+    EXPECT_PYTHON_ERR(PyExc_BufferError);
+}
+
+TEST(BufferView, format_mismatch) {
+    auto ob = doubles(4, py::tuple::pack(4_p));
+    ASSERT_NONNULL(ob);
+
+    py::buffer_view<const float> floats(ob);
+    EXPECT_FALSE(floats.is_nonnull());
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+
+    py::buffer_view<const long long> ints(ob);
+    EXPECT_FALSE(ints.is_nonnull());
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+
+    py::buffer_view<const double, 2> matrix(ob);
+    EXPECT_FALSE(matrix.is_nonnull());
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+
+    py::buffer_view<const double> good(ob);
+    EXPECT_TRUE(good.is_nonnull());
+    EXPECT_NO_PYTHON_ERR();
+}
+
+TEST(BufferView, strided) {
+    auto ob = doubles(6, py::tuple::pack(6_p));
+    ASSERT_NONNULL(ob);
+    py::tmpref<py::object> slice(PySlice_New(nullptr, nullptr, 2_p));
+    ASSERT_NONNULL(slice);
+    auto every_other = ob[slice];
+    ASSERT_NONNULL(every_other);
+
+    py::buffer_view<double> view(every_other);
+    ASSERT_TRUE(view.is_nonnull());
+    EXPECT_FALSE(view.is_contiguous());
+    ASSERT_EQ(view.shape(), 3);
+    EXPECT_EQ(view.stride(), 2 * static_cast<py::ssize_t>(sizeof(double)));
+
+    for (py::ssize_t n = 0; n < view.shape(); ++n) {
+        EXPECT_EQ(view[n], 2 * n);
+    }
+}
+
+TEST(BufferView, ndim) {
+    auto ob = doubles(6, py::tuple::pack(2_p, 3_p));
+    ASSERT_NONNULL(ob);
+
+    py::buffer_view<const double, 2> view(ob);
+    ASSERT_TRUE(view.is_nonnull());
+    ASSERT_EQ(view.shape(0), 2);
+    ASSERT_EQ(view.shape(1), 3);
+    EXPECT_EQ(view.size(), 6);
+
+    for (py::ssize_t row = 0; row < view.shape(0); ++row) {
+        for (py::ssize_t col = 0; col < view.shape(1); ++col) {
+            EXPECT_EQ(view(row, col), row * 3 + col);
+        }
+    }
+}
+
+TEST(BufferView, move) {
+    auto ob = doubles(2, py::tuple::pack(2_p));
+    ASSERT_NONNULL(ob);
+
+    py::buffer_view<const double> a(ob);
+    ASSERT_TRUE(a.is_nonnull());
+    py::buffer_view<const double> b(std::move(a));
+    EXPECT_FALSE(a.is_nonnull());
+    ASSERT_TRUE(b.is_nonnull());
+    EXPECT_EQ(b[1], 1);
+
+    a = std::move(b);
+    EXPECT_TRUE(a.is_nonnull());
+    EXPECT_FALSE(b.is_nonnull());
+}
+
+TEST(BufferView, move_outlives_source) {
+    py::tmpref<py::object> bytes(PyByteArray_FromStringAndSize("abc", 3));
+    ASSERT_NONNULL(bytes);
+
+    py::buffer_view<unsigned char> b;
+    {
+        // bytearray's shape and strides point into the source's Py_buffer
+        py::buffer_view<unsigned char> a(bytes);
+        ASSERT_TRUE(a.is_nonnull());
+        b = std::move(a);
+    }
+    ASSERT_TRUE(b.is_nonnull());
+    EXPECT_EQ(b.shape(), 3);
+    EXPECT_EQ(b.stride(), 1);
+    EXPECT_EQ(b[2], 'c');
+
+    std::optional<py::buffer_view<unsigned char>> c;
+    {
+        py::buffer_view<unsigned char> a(std::move(b));
+        c.emplace(std::move(a));
+    }
+    ASSERT_TRUE(c->is_nonnull());
+    EXPECT_EQ(c->shape(), 3);
+    EXPECT_EQ(c->stride(), 1);
+    EXPECT_EQ((*c)[1], 'b');
+}
+
+namespace {
+PyObject *sum(PyObject*, py::buffer_view<const double> view) {
+    double total = 0;
+    for (py::ssize_t n = 0; n < view.shape(); ++n) {
+        total += view[n];
+    }
+    return PyFloat_FromDouble(total);
+}
+
+PyMethodDef sum_def = automethod(sum);
+}
+
+TEST(BufferView, automethod) {
+    py::tmpref<py::object> f(PyCFunction_New(&sum_def, nullptr));
+    ASSERT_NONNULL(f);
+    auto ob = doubles(4, py::tuple::pack(4_p));
+    ASSERT_NONNULL(ob);
+
+    py::tmpref<py::object> result(
+        PyObject_CallFunctionObjArgs(f, static_cast<PyObject*>(ob), nullptr));
+    ASSERT_NONNULL(result);
+    EXPECT_EQ(PyFloat_AsDouble(result), 6);
+
+    py::tmpref<py::object> bad(
+        PyObject_CallFunctionObjArgs(f, static_cast<PyObject*>(1_p), nullptr));
+    EXPECT_IS(bad, nullptr);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+}
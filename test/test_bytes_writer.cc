@@ -0,0 +1,146 @@
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+#include <Python.h>
+
+#include "libpy/libpy.h"
+#include "utils.h"
+
+namespace {
+std::string_view as_string_view(const py::object &ob) {
+    return {PyBytes_AS_STRING(static_cast<PyObject*>(ob)),
+            static_cast<std::size_t>(
+                PyBytes_GET_SIZE(static_cast<PyObject*>(ob)))};
+}
+}
+
+TEST(BytesWriter, empty) {
+    for (py::ssize_t capacity : {0, 10}) {
+        py::bytes_writer writer(capacity);
+        ASSERT_TRUE(writer.is_nonnull());
+        EXPECT_EQ(writer.size(), 0);
+        EXPECT_EQ(writer.capacity(), capacity);
+
+        auto out = writer.finalize();
+        ASSERT_NONNULL(out);
+        ASSERT_TRUE(PyBytes_CheckExact(static_cast<PyObject*>(out)));
+        EXPECT_EQ(PyBytes_GET_SIZE(static_cast<PyObject*>(out)), 0);
+    }
+}
+
+TEST(BytesWriter, write) {
+    py::bytes_writer writer;
+    ASSERT_EQ(writer.write("ayy"), 0);
+    ASSERT_EQ(writer.put(' '), 0);
+    ASSERT_EQ(writer.write("lmao", 4), 0);
+    EXPECT_EQ(writer.size(), 8);
+
+    auto out = writer.finalize();
+    ASSERT_NONNULL(out);
+    EXPECT_EQ(as_string_view(out), "ayy lmao");
+    // the result is a normal bytes object and can be hashed and compared
+    py::tmpref<py::object> expected(PyBytes_FromString("ayy lmao"));
+    EXPECT_TRUE((out == expected).istrue());
+    EXPECT_EQ(out.hash(), expected.hash());
+
+    // the writer is reset
+    EXPECT_EQ(writer.size(), 0);
+    EXPECT_EQ(writer.capacity(), 0);
+}
+
+TEST(BytesWriter, preallocated_no_copy) {
+    py::bytes_writer writer(16);
+    char *start = writer.data();
+    ASSERT_NE(start, nullptr);
+
+    ASSERT_EQ(writer.write("0123456789"), 0);
+    EXPECT_EQ(writer.data(), start);
+    EXPECT_EQ(writer.capacity(), 16);
+
+    auto out = writer.finalize();
+    ASSERT_NONNULL(out);
+    EXPECT_EQ(as_string_view(out), "0123456789");
+}
+
+TEST(BytesWriter, geometric_growth) {
+    py::bytes_writer writer;
+    std::string expected;
+    int reallocations = 0;
+    py::ssize_t capacity = writer.capacity();
+
+    for (int n = 0; n < 100000; ++n) {
+        char c = 'a' + n % 26;
+        ASSERT_EQ(writer.put(c), 0);
+        expected.push_back(c);
+        if (writer.capacity() != capacity) {
+            capacity = writer.capacity();
+            ++reallocations;
+        }
+    }
+    EXPECT_LT(reallocations, 40);
+
+    auto out = writer.finalize();
+    ASSERT_NONNULL(out);
+    EXPECT_EQ(as_string_view(out), expected);
+}
+
+TEST(BytesWriter, prepare_commit) {
+    py::bytes_writer writer;
+    ASSERT_EQ(writer.write("header:"), 0);
+
+    char *out = writer.prepare(100);
+    ASSERT_NE(out, nullptr);
+    EXPECT_GE(writer.capacity() - writer.size(), 100);
+    std::memcpy(out, "body", 4);
+    writer.commit(4);
+
+    auto result = writer.finalize();
+    ASSERT_NONNULL(result);
+    EXPECT_EQ(as_string_view(result), "header:body");
+}
+
+TEST(BytesWriter, prepare_empty) {
+    py::bytes_writer writer;
+    ASSERT_NE(writer.prepare(0), nullptr);
+    writer.commit(0);
+    ASSERT_EQ(writer.write(nullptr, 0), 0);
+    EXPECT_EQ(writer.size(), 0);
+
+    auto result = writer.finalize();
+    ASSERT_NONNULL(result);
+    EXPECT_EQ(as_string_view(result), "");
+}
+
+TEST(BytesWriter, reserve_overflow) {
+    py::bytes_writer writer;
+    ASSERT_EQ(writer.write("abc"), 0);
+    EXPECT_NE(writer.reserve(PY_SSIZE_T_MAX - 1), 0);
+    EXPECT_PYTHON_ERR(PyExc_MemoryError);
+    EXPECT_FALSE(writer.is_nonnull());
+}
+
+TEST(BytesWriter, too_large) {
+    py::bytes_writer writer;
+    EXPECT_NE(writer.reserve(PY_SSIZE_T_MAX), 0);
+    EXPECT_PYTHON_ERR(PyExc_MemoryError);
+    EXPECT_FALSE(writer.is_nonnull());
+
+    EXPECT_NE(writer.put('a'), 0);
+    PyErr_Clear();
+    EXPECT_IS(writer.finalize(), nullptr);
+    PyErr_Clear();
+}
+
+TEST(BytesWriter, move) {
+    py::bytes_writer a;
+    ASSERT_EQ(a.write("ayy"), 0);
+
+    py::bytes_writer b(std::move(a));
+    EXPECT_EQ(a.size(), 0);
+    ASSERT_EQ(b.write(" lmao"), 0);
+
+    auto out = b.finalize();
+    ASSERT_NONNULL(out);
+    EXPECT_EQ(as_string_view(out), "ayy lmao");
+}
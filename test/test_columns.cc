@@ -0,0 +1,72 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include <Python.h>
+
+#include "libpy/libpy.h"
+#include "utils.h"
+
+TEST(Columns, round_trip) {
+    auto rows = eval("[(1, 1.5, 'a', True), (2, 2.5, 'b', False), "
+                     "(3, 3.5, 'c', True)]");
+    ASSERT_NONNULL(rows);
+
+    py::columns<std::int64_t, double, std::string, bool> cols;
+    ASSERT_EQ(cols.from_rows(rows), 0);
+    ASSERT_EQ(cols.size(), 3ul);
+    EXPECT_EQ(cols.get<0>(), (std::vector<std::int64_t>{1, 2, 3}));
+    EXPECT_EQ(cols.get<1>(), (std::vector<double>{1.5, 2.5, 3.5}));
+    EXPECT_EQ(cols.get<2>(), (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_EQ(cols.get<3>(), (std::vector<bool>{true, false, true}));
+
+    for (auto &value : cols.get<1>()) {
+        value *= 2;
+    }
+    auto out = cols.to_rows();
+    ASSERT_NONNULL(out);
+    auto expected = eval("[(1, 3.0, 'a', True), (2, 5.0, 'b', False), "
+                         "(3, 7.0, 'c', True)]");
+    ASSERT_NONNULL(expected);
+    EXPECT_TRUE((out == expected).istrue());
+
+    // reading a smaller batch reuses the columns
+    const std::int64_t *data = cols.get<0>().data();
+    ASSERT_EQ(cols.from_rows(eval("((4, 0.0, '', False),)")), 0);
+    ASSERT_EQ(cols.size(), 1ul);
+    EXPECT_EQ(cols.get<0>().data(), data);
+    EXPECT_EQ(cols.get<0>()[0], 4);
+
+    ASSERT_EQ(cols.from_rows(eval("[]")), 0);
+    EXPECT_EQ(cols.size(), 0ul);
+    auto empty = cols.to_rows();
+    ASSERT_NONNULL(empty);
+    EXPECT_EQ(empty.len(), 0);
+}
+
+TEST(Columns, errors) {
+    py::columns<int, double> cols;
+
+    struct subtest {
+        const char *source;
+        PyObject *exc;
+    };
+
+    for (const auto &subtest : {
+            subtest{"{(1, 2.0)}", PyExc_TypeError},
+            subtest{"[(1, 2.0), [3, 4.0]]", PyExc_TypeError},
+            subtest{"[(1, 2.0), (3,)]", PyExc_ValueError},
+            subtest{"[(1, 2.0), (3, 'a')]", PyExc_TypeError},
+            subtest{"[(2 ** 40, 2.0)]", PyExc_OverflowError}}) {
+        auto rows = eval(subtest.source);
+        ASSERT_NONNULL(rows);
+        EXPECT_NE(cols.from_rows(rows), 0) << subtest.source;
+        EXPECT_PYTHON_ERR(subtest.exc);
+    }
+
+    cols.resize(2);
+    cols.get<1>().push_back(1.0);
+    EXPECT_IS(cols.to_rows(), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+}
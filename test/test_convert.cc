@@ -0,0 +1,268 @@
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include <Python.h>
+
+#include "libpy/automethod.h"
+#include "libpy/libpy.h"
+#include "utils.h"
+
+using py::operator""_p;
+
+namespace {
+/**
+   Convert `value` to Python, check that it equals the result of evaluating
+   `source`, then convert it back and check that the round trip is lossless.
+*/
+template<typename T>
+void check_round_trip(const T &value, const char *source) {
+    py::tmpref<py::object> ob(py::to_python<T>::f(value));
+    ASSERT_NONNULL(ob);
+    auto expected = eval(source);
+    ASSERT_NONNULL(expected);
+    EXPECT_TRUE((ob == expected).istrue()) << source;
+
+    T out{};
+    ASSERT_EQ(py::from_python<T>::f(ob, out), 0) << source;
+    EXPECT_EQ(out, value) << source;
+}
+}
+
+TEST(Convert, scalars) {
+    check_round_trip(1, "1");
+    check_round_trip(std::int64_t(-1) << 40, "-(2 ** 40)");
+    check_round_trip(2.5, "2.5");
+    check_round_trip(true, "True");
+    check_round_trip(std::string("h\xc3\xa9llo"), "'h\\xe9llo'");
+}
+
+TEST(Convert, sequences) {
+    check_round_trip(std::vector<double>{1.5, 2.5, 2.5}, "[1.5, 2.5, 2.5]");
+    check_round_trip(std::vector<bool>{true, false}, "[True, False]");
+    check_round_trip(std::array<std::uint8_t, 3>{1, 2, 3}, "[1, 2, 3]");
+    check_round_trip(std::vector<std::vector<std::int64_t>>{{1, 2}, {}, {3}},
+                     "[[1, 2], [], [3]]");
+    check_round_trip(std::vector<std::string>{"a", "bc"}, "['a', 'bc']");
+
+    // any sequence may be converted into a vector
+    std::vector<int> ints;
+    ASSERT_EQ(py::from_python<std::vector<int>>::f(eval("(1, 2)"), ints), 0);
+    EXPECT_EQ(ints, (std::vector<int>{1, 2}));
+    ASSERT_EQ(py::from_python<std::vector<int>>::f(eval("range(3)"), ints), 0);
+    EXPECT_EQ(ints, (std::vector<int>{0, 1, 2}));
+
+    EXPECT_NE(py::from_python<std::vector<int>>::f(eval("'abc'"), ints), 0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+
+    std::array<int, 3> array;
+    EXPECT_NE((py::from_python<std::array<int, 3>>::f(eval("[1, 2]"), array)),
+              0);
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+}
+
+TEST(Convert, tuples) {
+    check_round_trip(std::make_tuple(1, std::string("a"), 2.5),
+                     "(1, 'a', 2.5)");
+    check_round_trip(std::make_pair(std::vector<int>{1}, false),
+                     "([1], False)");
+    check_round_trip(std::make_tuple(), "()");
+
+    std::pair<int, int> pair;
+    EXPECT_NE((py::from_python<std::pair<int, int>>::f(eval("(1, 2, 3)"),
+                                                       pair)),
+              0);
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+
+    EXPECT_NE((py::from_python<std::pair<int, int>>::f(eval("(1, 'a')"),
+                                                       pair)),
+              0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+}
+
+TEST(Convert, optional) {
+    check_round_trip(std::optional<int>(), "None");
+    check_round_trip(std::optional<int>(3), "3");
+    check_round_trip(std::vector<std::optional<double>>{1.0, std::nullopt},
+                     "[1.0, None]");
+}
+
+TEST(Convert, maps) {
+    check_round_trip(std::map<std::string, std::vector<int>>{{"a", {1, 2}},
+                                                             {"b", {}}},
+                     "{'a': [1, 2], 'b': []}");
+    check_round_trip(std::unordered_map<int, double>{{1, 1.5}, {2, 2.5}},
+                     "{1: 1.5, 2: 2.5}");
+
+    std::map<int, int> map;
+    EXPECT_NE((py::from_python<std::map<int, int>>::f(eval("[(1, 2)]"), map)),
+              0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+}
+
+TEST(Convert, map_mutated_during_conversion) {
+    py::tmpref<py::object> d(PyDict_New());
+    ASSERT_NONNULL(d);
+    // a sequence whose items clear `d` when read
+    auto clearing = eval(
+        "lambda d: type('S', (), {'__len__': lambda s: 1,"
+        "                         '__getitem__': lambda s, i: d.clear() or"
+        "                                                     [1][i]})()");
+    ASSERT_NONNULL(clearing);
+    for (const char *key : {"a", "b"}) {
+        py::tmpref<py::object> seq(
+            PyObject_CallFunctionObjArgs(clearing,
+                                         static_cast<PyObject*>(d),
+                                         nullptr));
+        ASSERT_NONNULL(seq);
+        ASSERT_EQ(PyDict_SetItemString(d, key, seq), 0);
+    }
+
+    // iterating the first value clears the dict, freeing both entries
+    std::map<std::string, std::vector<int>> map;
+    EXPECT_NE((py::from_python<decltype(map)>::f(d, map)), 0);
+    EXPECT_PYTHON_ERR(PyExc_RuntimeError);
+}
+
+TEST(Convert, objects) {
+    auto l = eval("[1, 2]");
+    ASSERT_NONNULL(l);
+
+    py::list::object out;
+    ASSERT_EQ(py::from_python<py::list::object>::f(l, out), 0);
+    EXPECT_IS(out, l);
+
+    EXPECT_NE(py::from_python<py::list::object>::f(1_p, out), 0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+
+    std::vector<py::object> objects;
+    ASSERT_EQ(py::from_python<std::vector<py::object>>::f(l, objects), 0);
+    ASSERT_EQ(objects.size(), 2ul);
+    EXPECT_IS(objects[0], 1_p);
+
+    py::tmpref<py::object> back(
+        py::to_python<std::vector<py::object>>::f(objects));
+    ASSERT_NONNULL(back);
+    EXPECT_TRUE((back == l).istrue());
+}
+
+TEST(Convert, borrowed_objects) {
+    // the elements of a range are owned only by the temporary tuple made
+    // while converting, so borrowing them is rejected
+    auto r = eval("range(1000, 1003)");
+    ASSERT_NONNULL(r);
+
+    std::vector<py::object> objects;
+    EXPECT_NE(py::from_python<std::vector<py::object>>::f(r, objects), 0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+
+    std::pair<py::object, int> pair;
+    EXPECT_NE((py::from_python<std::pair<py::object, int>>::f(
+                   eval("range(2)"), pair)),
+              0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+
+    std::vector<std::vector<py::object>> nested;
+    EXPECT_NE((py::from_python<std::vector<std::vector<py::object>>>::f(
+                   eval("(range(2),)"), nested)),
+              0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+
+    // values are copied out so they may be read from any sequence
+    std::vector<long> values;
+    ASSERT_EQ(py::from_python<std::vector<long>>::f(r, values), 0);
+    EXPECT_EQ(values, (std::vector<long>{1000, 1001, 1002}));
+
+    // a list owns its elements so they may be borrowed
+    auto l = eval("list(range(1000, 1003))");
+    ASSERT_NONNULL(l);
+    ASSERT_EQ(py::from_python<std::vector<py::object>>::f(l, objects), 0);
+    ASSERT_EQ(objects.size(), 3ul);
+    for (std::size_t ix = 0; ix < objects.size(); ++ix) {
+        long value;
+        ASSERT_EQ(py::unbox(objects[ix], value), 0);
+        EXPECT_EQ(value, static_cast<long>(1000 + ix));
+    }
+}
+
+namespace {
+std::map<std::string, double> describe(PyObject*,
+                                       std::vector<double> values,
+                                       std::string name) {
+    double total = 0;
+    for (double value : values) {
+        total += value;
+    }
+    return {{name, total}, {"count", values.size()}};
+}
+
+PyMethodDef describe_def = automethod(describe);
+
+void fail(PyObject*) {
+    PyErr_SetString(PyExc_ValueError, "failed");
+}
+
+PyMethodDef fail_def = automethod(fail);
+
+long long add(PyObject*, int a, unsigned long long b) {
+    return a + b;
+}
+
+PyMethodDef add_def = automethod(add);
+}
+
+TEST(Convert, automethod) {
+    py::tmpref<py::object> f(PyCFunction_New(&describe_def, nullptr));
+    ASSERT_NONNULL(f);
+
+    auto result = f(eval("[1.0, 2, 3.5]"), "total"_p);
+    ASSERT_NONNULL(result);
+    auto expected = eval("{'total': 6.5, 'count': 3.0}");
+    ASSERT_NONNULL(expected);
+    EXPECT_TRUE((result == expected).istrue());
+
+    EXPECT_IS(f(eval("[1.0, 'a']"), "total"_p), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+
+    py::tmpref<py::object> g(PyCFunction_New(&fail_def, nullptr));
+    ASSERT_NONNULL(g);
+    EXPECT_IS(g(), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+}
+
+TEST(Convert, automethod_integers) {
+    py::tmpref<py::object> f(PyCFunction_New(&add_def, nullptr));
+    ASSERT_NONNULL(f);
+
+    auto big = eval("2 ** 40");
+    ASSERT_NONNULL(big);
+    auto result = f(1_p, big);
+    ASSERT_NONNULL(result);
+    auto expected = eval("2 ** 40 + 1");
+    ASSERT_NONNULL(expected);
+    EXPECT_TRUE((result == expected).istrue());
+
+    auto negative = eval("-1");
+    ASSERT_NONNULL(negative);
+    EXPECT_IS(f(1_p, negative), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_OverflowError);
+
+    EXPECT_IS(f(big, 1_p), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_OverflowError);
+
+    // `int` subclasses are accepted like they were by the `i` and `K`
+    // typeformats
+    auto member = eval(
+        "__import__('enum').IntEnum('E', 'a b c', module='test').c");
+    ASSERT_NONNULL(member);
+    auto subclass_result = f(py::object(Py_True), member);
+    ASSERT_NONNULL(subclass_result);
+    EXPECT_TRUE((subclass_result == 4_p).istrue());
+}
@@ -0,0 +1,151 @@
+#include <array>
+
+#include "gtest/gtest.h"
+#include <Python.h>
+
+#include "libpy/libpy.h"
+#include "utils.h"
+
+using py::operator""_p;
+
+TEST(Dict, type) {
+    ASSERT_EQ(static_cast<PyObject*>(py::dict::type),
+              reinterpret_cast<PyObject*>(&PyDict_Type));
+    auto d = py::dict::type();
+
+    EXPECT_EQ(static_cast<PyObject*>(d.type()),
+              reinterpret_cast<PyObject*>(&PyDict_Type));
+}
+
+TEST(Dict, from_non_dict) {
+    py::dict::object d(1_p);
+
+    EXPECT_IS(d, nullptr);
+    EXPECT_PYTHON_ERR(py::err::TypeError);
+}
+
+TEST(HashedKey, hash) {
+    py::hashed_key key("ayy"_p);
+
+    EXPECT_IS(key.key(), "ayy"_p);
+    EXPECT_EQ(key.hash(), "ayy"_p.hash());
+    EXPECT_TRUE(key.is_nonnull());
+}
+
+TEST(HashedKey, unhashable) {
+    auto unhashable = py::list::pack(1_p);
+    py::hashed_key key(unhashable);
+
+    EXPECT_FALSE(key.is_nonnull());
+    EXPECT_PYTHON_ERR(py::err::TypeError);
+}
+
+TEST(Dict, hashed_key) {
+    std::array<py::tmpref<py::dict::object>, 3> ds = {
+        py::dict::object(0), py::dict::object(0), py::dict::object(0)};
+    py::hashed_key key("ayy"_p);
+
+    for (const auto &d : ds) {
+        ASSERT_NONNULL(d);
+        EXPECT_EQ(d.contains(key), 0);
+        ASSERT_EQ(d.setitem(key, 1_p), 0);
+        EXPECT_EQ(d.contains(key), 1);
+        EXPECT_IS(d[key], 1_p);
+        EXPECT_IS(d.getitem(key), 1_p);
+        // the hashed key must agree with the normal lookup
+        EXPECT_IS(d["ayy"_p], 1_p);
+    }
+
+    for (const auto &d : ds) {
+        ASSERT_EQ(d.delitem(key), 0);
+        EXPECT_EQ(d.contains(key), 0);
+        EXPECT_NO_PYTHON_ERR();
+    }
+}
+
+TEST(Dict, hashed_key_missing) {
+    py::tmpref<py::dict::object> d(0);
+    auto missing = py::tuple::pack(1_p, 2_p);
+    py::hashed_key key(missing);
+
+    EXPECT_IS(d[key], nullptr);
+    EXPECT_PYTHON_ERR(py::err::KeyError);
+
+    EXPECT_NE(d.delitem(key), 0);
+    EXPECT_PYTHON_ERR(py::err::KeyError);
+}
+
+TEST(Dict, presized) {
+    for (py::ssize_t len : {0, 1, 100}) {
+        py::tmpref<py::dict::object> d(len);
+        ASSERT_NONNULL(d);
+        EXPECT_EQ(d.len(), 0);
+    }
+}
+
+TEST(Dict, iteration) {
+    py::tmpref<py::dict::object> d(3);
+    ASSERT_NONNULL(d);
+    std::array<py::object, 3> keys = {"a"_p, "b"_p, "c"_p};
+    std::array<py::object, 3> values = {0_p, 1_p, 2_p};
+
+    for (std::size_t n = 0; n < keys.size(); ++n) {
+        ASSERT_EQ(d.setitem(keys[n], values[n]), 0);
+    }
+
+    // dicts preserve insertion order
+    std::size_t n = 0;
+    for (const auto &item : d) {
+        EXPECT_IS(item.first, keys[n]);
+        EXPECT_IS(item.second, values[n]);
+        ++n;
+    }
+    EXPECT_EQ(n, 3u);
+
+    n = 0;
+    for (const auto &item : d.as_nonnull()) {
+        EXPECT_IS(item.first, keys[n]);
+        ++n;
+    }
+    EXPECT_EQ(n, 3u);
+    EXPECT_EQ(d.as_nonnull().len(), 3);
+}
+
+TEST(Dict, iteration_empty) {
+    py::tmpref<py::dict::object> d(0);
+    ASSERT_NONNULL(d);
+
+    EXPECT_TRUE(d.begin() == d.end());
+}
+
+TEST(Dict, get) {
+    py::tmpref<py::dict::object> d(0);
+    ASSERT_NONNULL(d);
+    ASSERT_EQ(d.setitem("a"_p, 1_p), 0);
+    py::hashed_key a("a"_p);
+    py::hashed_key b("b"_p);
+
+    EXPECT_IS(d.get("a"_p), 1_p);
+    EXPECT_IS(d.get(a), 1_p);
+    EXPECT_IS(d.get("b"_p), nullptr);
+    EXPECT_IS(d.get(b), nullptr);
+    EXPECT_NO_PYTHON_ERR();
+
+    EXPECT_IS(d.get("b"_p, 2_p), 2_p);
+    EXPECT_IS(d.get(b, 2_p), 2_p);
+    EXPECT_IS(d.get(a, 2_p), 1_p);
+    EXPECT_NO_PYTHON_ERR();
+}
+
+TEST(Dict, setdefault) {
+    py::tmpref<py::dict::object> d(0);
+    ASSERT_NONNULL(d);
+    py::hashed_key b("b"_p);
+
+    EXPECT_IS(d.setdefault("a"_p, 1_p), 1_p);
+    EXPECT_IS(d.setdefault("a"_p, 2_p), 1_p);
+    EXPECT_IS(d.setdefault(b, 3_p), 3_p);
+    EXPECT_IS(d.setdefault(b, 4_p), 3_p);
+    EXPECT_EQ(d.len(), 2);
+    EXPECT_NO_PYTHON_ERR();
+}
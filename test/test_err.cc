@@ -1,4 +1,6 @@
 #include <exception>
+#include <string>
+#include <string_view>
 
 #include <gtest/gtest.h>
 #include <Python.h>
@@ -13,6 +15,14 @@ TEST(Err, raise_with_message) {
     EXPECT_PYTHON_ERR_MSG(py::err::TypeError, "ayy lmao: 1"_p);
 }
 
+TEST(Err, raise_with_formatted_message) {
+    py::err::raise(py::err::ValueError) << "bad row " << 12 << " of "
+                                        << 1.5 << ": " << "\xc3\xa9"
+                                        << " " << "x"_p;
+    EXPECT_PYTHON_ERR_MSG(py::err::ValueError,
+                          "bad row 12 of 1.5: \u00e9 x"_p);
+}
+
 TEST(Err, raise_value) {
     py::err::raise(py::err::TypeError("ayy lmao"_p));
     EXPECT_PYTHON_ERR_MSG(py::err::TypeError, "ayy lmao"_p);
@@ -43,3 +53,192 @@ TEST(Err, occurred) {
     EXPECT_IS(py::err::occurred(), py::err::TypeError);
     py::err::clear();
 }
+
+TEST(Err, raise_lazy) {
+    auto value = eval("[1, 2]");
+    ASSERT_NONNULL(value);
+    Py_ssize_t refcnt = Py_REFCNT(value);
+
+    EXPECT_EQ(py::err::raise_lazy(py::err::ValueError,
+                                  "bad row ",
+                                  12,
+                                  ": ",
+                                  value),
+              nullptr);
+    // the message holds a reference to its parts until it is formatted
+    EXPECT_EQ(Py_REFCNT(value), refcnt + 1);
+    EXPECT_PYTHON_ERR_MSG(py::err::ValueError, "bad row 12: [1, 2]"_p);
+    EXPECT_EQ(Py_REFCNT(value), refcnt);
+}
+
+TEST(Err, raise_lazy_cleared) {
+    auto value = eval("object()");
+    ASSERT_NONNULL(value);
+    Py_ssize_t refcnt = Py_REFCNT(value);
+
+    py::err::raise_lazy(py::err::TypeError, "expected int, got ", value);
+    EXPECT_TRUE(PyErr_ExceptionMatches(py::err::TypeError));
+    PyErr_Clear();
+    EXPECT_EQ(Py_REFCNT(value), refcnt);
+}
+
+TEST(Err, raise_lazy_string_view) {
+    {
+        std::string name = "column";
+        py::err::raise_lazy(py::err::ValueError,
+                            "bad ",
+                            std::string_view(name));
+        // the view's buffer is overwritten before the message is read
+        name.assign("xxxxxx");
+    }
+    EXPECT_PYTHON_ERR_MSG(py::err::ValueError, "bad column"_p);
+}
+
+TEST(Err, raise_lazy_message) {
+    py::err::raise_lazy(py::err::KeyError, "missing ", 1.5);
+
+    PyObject *type;
+    PyObject *value;
+    PyObject *tb;
+    PyErr_Fetch(&type, &value, &tb);
+    PyErr_NormalizeException(&type, &value, &tb);
+    py::tmpref<py::object> type_ref(type);
+    py::tmpref<py::object> value_ref(value);
+    py::tmpref<py::object> tb_ref(tb);
+
+    auto args = value_ref.getattr("args"_p);
+    ASSERT_NONNULL(args);
+    auto message = args[0];
+    ASSERT_NONNULL(message);
+    EXPECT_TRUE((message == "missing 1.5"_p).istrue());
+    EXPECT_EQ(message.hash(), "missing 1.5"_p.hash());
+
+    // KeyError uses the repr of its argument
+    EXPECT_TRUE((value_ref.str() == "'missing 1.5'"_p).istrue());
+}
+
+TEST(Err, raise_lazy_pickle) {
+    auto round_trip = eval(
+        "lambda e: __import__('pickle').loads(__import__('pickle').dumps(e))");
+    ASSERT_NONNULL(round_trip);
+
+    py::err::raise_lazy(py::err::ValueError, "bad row ", 12);
+    PyObject *type;
+    PyObject *value;
+    PyObject *tb;
+    PyErr_Fetch(&type, &value, &tb);
+    PyErr_NormalizeException(&type, &value, &tb);
+    py::tmpref<py::object> type_ref(type);
+    py::tmpref<py::object> value_ref(value);
+    py::tmpref<py::object> tb_ref(tb);
+
+    auto copy = round_trip(value_ref);
+    ASSERT_NONNULL(copy);
+    EXPECT_TRUE(PyErr_GivenExceptionMatches(copy, py::err::ValueError));
+    auto args = copy.getattr("args"_p);
+    ASSERT_NONNULL(args);
+    auto message = args[0];
+    ASSERT_NONNULL(message);
+    EXPECT_TRUE(PyUnicode_CheckExact(message));
+    EXPECT_TRUE((message == "bad row 12"_p).istrue());
+}
+
+TEST(Err, raise_lazy_cycle) {
+    auto make = eval("type('holder', (), {})");
+    ASSERT_NONNULL(make);
+    auto weakref = eval("__import__('weakref').ref");
+    ASSERT_NONNULL(weakref);
+    auto collect = eval("__import__('gc').collect");
+    ASSERT_NONNULL(collect);
+
+    auto holder = make();
+    ASSERT_NONNULL(holder);
+    auto ref = weakref(holder);
+    ASSERT_NONNULL(ref);
+
+    // holder -> exception -> message -> holder
+    py::err::raise_lazy(py::err::ValueError, "bad holder ", holder);
+    PyObject *type;
+    PyObject *value;
+    PyObject *tb;
+    PyErr_Fetch(&type, &value, &tb);
+    PyErr_NormalizeException(&type, &value, &tb);
+    ASSERT_EQ(holder.setattr("exc"_p, py::object(value)), 0);
+    Py_DECREF(type);
+    Py_DECREF(value);
+    Py_XDECREF(tb);
+
+    PyObject *released = holder;
+    std::move(holder).invalidate();
+    Py_DECREF(released);
+    EXPECT_IS_NOT(ref(), Py_None);
+
+    ASSERT_NONNULL(collect());
+    EXPECT_IS(ref(), Py_None);
+}
+
+TEST(Err, raise_sentinel) {
+    EXPECT_EQ(py::err::raise_sentinel(py::err::KeyError), nullptr);
+
+    PyObject *type;
+    PyObject *value;
+    PyObject *tb;
+    PyErr_Fetch(&type, &value, &tb);
+    ASSERT_TRUE(PyErr_GivenExceptionMatches(type, py::err::KeyError));
+    PyErr_NormalizeException(&type, &value, &tb);
+    Py_DECREF(type);
+    Py_XDECREF(tb);
+    PyObject *first = value;
+    Py_DECREF(value);
+
+    // nothing else holds the first instance so it is raised again
+    py::err::raise_sentinel(py::err::KeyError);
+    PyErr_Fetch(&type, &value, &tb);
+    PyErr_NormalizeException(&type, &value, &tb);
+    EXPECT_EQ(value, first);
+    Py_DECREF(type);
+    Py_XDECREF(tb);
+
+    // while the instance is held a new one is raised
+    py::err::raise_sentinel(py::err::KeyError);
+    PyObject *held = value;
+    PyErr_Fetch(&type, &value, &tb);
+    PyErr_NormalizeException(&type, &value, &tb);
+    EXPECT_NE(value, held);
+    Py_DECREF(type);
+    Py_DECREF(value);
+    Py_XDECREF(tb);
+    Py_DECREF(held);
+
+    py::err::raise_sentinel(py::err::StopIteration);
+    EXPECT_PYTHON_ERR(py::err::StopIteration);
+}
+
+TEST(Err, raise_sentinel_state) {
+    // state added to a caught sentinel must not leak into the next raise
+    auto probe = eval(
+        "lambda e: (setattr(e, 'value', 42),"
+        "           getattr(e, 'add_note', id)('stale note'))");
+    ASSERT_NONNULL(probe);
+
+    py::err::raise_sentinel(py::err::StopIteration);
+    PyObject *type;
+    PyObject *value;
+    PyObject *tb;
+    PyErr_Fetch(&type, &value, &tb);
+    PyErr_NormalizeException(&type, &value, &tb);
+    ASSERT_NONNULL(probe(py::object(value)));
+    Py_DECREF(type);
+    Py_DECREF(value);
+    Py_XDECREF(tb);
+
+    py::err::raise_sentinel(py::err::StopIteration);
+    PyErr_Fetch(&type, &value, &tb);
+    PyErr_NormalizeException(&type, &value, &tb);
+    py::tmpref<py::object> type_ref(type);
+    py::tmpref<py::object> value_ref(value);
+    py::tmpref<py::object> tb_ref(tb);
+
+    EXPECT_IS(value_ref.getattr("value"_p), Py_None);
+    EXPECT_FALSE(PyObject_HasAttrString(value, "__notes__"));
+}
@@ -0,0 +1,188 @@
+#include <clocale>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "libpy/libpy.h"
+#include "utils.h"
+
+using py::operator""_p;
+
+TEST(Float, default) {
+    py::float_::object n;
+
+    EXPECT_IS(n, nullptr);
+    EXPECT_EQ(PyErr_Occurred(), nullptr) << py::err::occurred();
+}
+
+TEST(Float, from_numeric) {
+    auto d = py::float_::object(2.5).as_tmpref();
+    EXPECT_EQ(d.as_double(), 2.5);
+
+    auto i = py::float_::object(3).as_tmpref();
+    EXPECT_EQ(i.as_double(), 3.0);
+    EXPECT_NO_PYTHON_ERR();
+}
+
+TEST(Float, from_non_float) {
+    py::float_::object n(1_p);
+    EXPECT_IS(n, nullptr);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+}
+
+TEST(Float, check) {
+    auto n = 1.5_p;
+
+    EXPECT_TRUE(py::float_::check(n));
+    EXPECT_TRUE(py::float_::checkexact(n));
+    EXPECT_FALSE(py::float_::check(1_p));
+    EXPECT_IS(py::float_::type, reinterpret_cast<PyObject*>(&PyFloat_Type));
+}
+
+namespace {
+py::tmpref<py::object> apply(std::size_t ix,
+                             const py::float_::object &lhs,
+                             const py::object &rhs) {
+    switch (ix) {
+    case 0:
+        return lhs + rhs;
+    case 1:
+        return lhs - rhs;
+    case 2:
+        return lhs * rhs;
+    case 3:
+        return lhs / rhs;
+    default:
+        return lhs % rhs;
+    }
+}
+}
+
+TEST(Float, operators) {
+    std::vector<const char*> values = {"0.0", "-0.0", "1.5", "-2.25",
+                                       "1e308", "float('inf')",
+                                       "float('nan')", "3", "-7", "2 ** 100"};
+
+    using op = PyObject *(*)(PyObject*, PyObject*);
+    std::vector<std::pair<op, const char*>> ops = {
+        {PyNumber_Add, " + "},
+        {PyNumber_Subtract, " - "},
+        {PyNumber_Multiply, " * "},
+        {PyNumber_TrueDivide, " / "},
+        {PyNumber_Remainder, " % "},
+    };
+
+    for (const char *a_source : values) {
+        auto a = eval(a_source);
+        ASSERT_NONNULL(a);
+        if (!PyFloat_Check(a)) {
+            continue;
+        }
+        py::float_::object lhs(a);
+
+        for (const char *b_source : values) {
+            auto b = eval(b_source);
+            ASSERT_NONNULL(b);
+
+            for (std::size_t ix = 0; ix < ops.size(); ++ix) {
+                const auto &[expected_func, name] = ops[ix];
+                py::tmpref<py::object> expected(expected_func(a, b));
+                PyObject *expected_err = PyErr_Occurred();
+                PyErr_Clear();
+
+                auto result = apply(ix, lhs, b);
+                if (!expected.is_nonnull()) {
+                    EXPECT_IS(result, nullptr) << a_source << name << b_source;
+                    EXPECT_TRUE(PyErr_ExceptionMatches(expected_err));
+                    PyErr_Clear();
+                    continue;
+                }
+                ASSERT_NONNULL(result) << a_source << name << b_source;
+                ASSERT_TRUE(PyFloat_Check(result));
+
+                // compare bits so that the signs of zeros and nans match
+                double expected_value =
+                    PyFloat_AS_DOUBLE(static_cast<PyObject*>(expected));
+                double value =
+                    PyFloat_AS_DOUBLE(static_cast<PyObject*>(result));
+                if (std::isnan(expected_value)) {
+                    EXPECT_TRUE(std::isnan(value))
+                        << a_source << name << b_source;
+                }
+                else {
+                    EXPECT_EQ(value, expected_value)
+                        << a_source << name << b_source;
+                    EXPECT_EQ(std::signbit(value), std::signbit(expected_value))
+                        << a_source << name << b_source;
+                }
+            }
+        }
+    }
+}
+
+TEST(Float, reuse_temporary) {
+    auto a = py::float_::object(1.5).as_tmpref();
+    auto b = py::float_::object(2.0).as_tmpref();
+    ASSERT_TRUE(pyutils::all_nonnull(a, b));
+
+    auto product = a * b;
+    ASSERT_NONNULL(product);
+    PyObject *storage = product;
+
+    // the only reference to the product is reused for the sum
+    auto sum = std::move(product) + b;
+    EXPECT_IS(sum, storage);
+    EXPECT_EQ(sum.as_double(), 5.0);
+
+    // a temporary which is shared must not be written to
+    auto shared = sum;
+    auto difference = std::move(sum) - 1_p;
+    ASSERT_NONNULL(difference);
+    EXPECT_IS_NOT(difference, storage);
+    EXPECT_EQ(difference.as_double(), 4.0);
+    EXPECT_EQ(shared.as_double(), 5.0);
+
+    // inputs which are not read in C++ go through the number protocol
+    auto c = eval("2 ** 100");
+    ASSERT_NONNULL(c);
+    auto big = a * b + c;
+    ASSERT_NONNULL(big);
+    auto expected = eval("3.0 + 2 ** 100");
+    ASSERT_NONNULL(expected);
+    EXPECT_TRUE((big == expected).istrue());
+}
+
+TEST(Float, literals) {
+    const py::float_::object &a = 2.5_p;
+    EXPECT_EQ(a.as_double(), 2.5);
+    EXPECT_IS(a, 2.5_p);
+
+    EXPECT_EQ((1'000.25_p).as_double(), 1000.25);
+    EXPECT_EQ((0x1p4_p).as_double(), 16.0);
+    EXPECT_EQ((1e-3_p).as_double(), 1e-3);
+    EXPECT_EQ((0x1.8p1_p).as_double(), 3.0);
+    EXPECT_EQ((0X.8P0_p).as_double(), 0.5);
+}
+
+TEST(Float, literals_ignore_locale) {
+    std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+    if (!std::setlocale(LC_NUMERIC, "de_DE.UTF-8")) {
+        GTEST_SKIP() << "no locale with a decimal comma";
+    }
+
+    // the decimal point in the literal must not depend on the locale
+    double value = (4.75_p).as_double();
+    std::setlocale(LC_NUMERIC, previous.c_str());
+    EXPECT_EQ(value, 4.75);
+}
+
+TEST(Float, unary) {
+    auto n = py::float_::object(-2.5).as_tmpref();
+    EXPECT_EQ((-n).as_double(), 2.5);
+    EXPECT_EQ(n.abs().as_double(), 2.5);
+    EXPECT_EQ((+n).as_double(), -2.5);
+}
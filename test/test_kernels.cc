@@ -0,0 +1,360 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include <Python.h>
+
+#include "libpy/kernels.h"
+#include "libpy/libpy.h"
+#include "utils.h"
+
+using py::operator""_p;
+namespace k = py::kernels;
+
+namespace {
+template<typename T>
+const char *format_of() {
+    if (std::is_same<T, float>::value) {
+        return "f";
+    }
+    if (std::is_same<T, double>::value) {
+        return "d";
+    }
+    return sizeof(T) == 4 ? "i" : "q";
+}
+
+/**
+   Copy a vector into a new `memoryview` with the format of `T`, optionally
+   cast to a new shape.
+*/
+template<typename T>
+py::tmpref<py::object> to_buffer(const std::vector<T> &values,
+                                 const py::object &shape = nullptr) {
+    py::tmpref<py::object> bytes(PyByteArray_FromStringAndSize(
+        reinterpret_cast<const char*>(values.data()),
+        values.size() * sizeof(T)));
+    if (!bytes.is_nonnull()) {
+        return nullptr;
+    }
+    py::tmpref<py::object> view(PyMemoryView_FromObject(bytes));
+    if (!view.is_nonnull()) {
+        return nullptr;
+    }
+    if (shape.is_nonnull()) {
+        return PyObject_CallMethod(view,
+                                   "cast",
+                                   "sO",
+                                   format_of<T>(),
+                                   static_cast<PyObject*>(shape));
+    }
+    return PyObject_CallMethod(view, "cast", "s", format_of<T>());
+}
+
+/**
+   The targets supported on this machine.
+*/
+std::vector<k::target> targets() {
+    std::vector<k::target> out;
+    for (auto t : {k::target::baseline, k::target::avx2, k::target::avx512}) {
+        if (k::supported(t)) {
+            out.push_back(t);
+        }
+    }
+    return out;
+}
+
+/**
+   Run the test body once for each supported target.
+*/
+class Kernels : public testing::Test {
+protected:
+    k::target original;
+
+    void SetUp() override {
+        original = k::active_target();
+    }
+
+    void TearDown() override {
+        ASSERT_EQ(k::set_target(original), 0);
+    }
+};
+
+// lengths that exercise a single element, the scalar tail and multiple
+// blocks; empty buffers are covered by the buffer_view tests
+const std::vector<py::ssize_t> lengths = {1, 3, 16, 17, 64, 1000, 1031};
+
+template<typename T>
+void check_reductions() {
+    for (py::ssize_t len : lengths) {
+        std::vector<T> values(len);
+        for (py::ssize_t ix = 0; ix < len; ++ix) {
+            // a permutation of 0..len - 1 so that min and max are unique
+            values[ix] = static_cast<T>((ix * 7) % len);
+        }
+
+        T expected_sum = static_cast<T>(len * (len - 1) / 2);
+        EXPECT_EQ(k::sum(values.data(), len), expected_sum) << len;
+        EXPECT_EQ(k::min(values.data(), len), 0) << len;
+        EXPECT_EQ(k::max(values.data(), len), len - 1) << len;
+
+        py::ssize_t argmin = k::argmin(values.data(), len);
+        py::ssize_t argmax = k::argmax(values.data(), len);
+        EXPECT_EQ(values[argmin], 0) << len;
+        EXPECT_EQ(values[argmax], len - 1) << len;
+    }
+}
+}
+
+TEST_F(Kernels, reductions) {
+    for (auto t : targets()) {
+        ASSERT_EQ(k::set_target(t), 0);
+        check_reductions<float>();
+        check_reductions<double>();
+        check_reductions<std::int32_t>();
+        check_reductions<std::int64_t>();
+    }
+}
+
+TEST_F(Kernels, set_unsupported_target) {
+    if (k::supported(k::target::avx512)) {
+        return;
+    }
+    EXPECT_NE(k::set_target(k::target::avx512), 0);
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+}
+
+TEST_F(Kernels, argmin_first_occurrence) {
+    for (auto t : targets()) {
+        ASSERT_EQ(k::set_target(t), 0);
+        std::vector<double> values(100, 5);
+        values[40] = 1;
+        values[70] = 1;
+        values[33] = 9;
+        values[90] = 9;
+        EXPECT_EQ(k::argmin(values.data(), values.size()), 40);
+        EXPECT_EQ(k::argmax(values.data(), values.size()), 33);
+    }
+}
+
+TEST_F(Kernels, nan) {
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    for (auto t : targets()) {
+        ASSERT_EQ(k::set_target(t), 0);
+        for (py::ssize_t nan_ix : {0, 20, 99}) {
+            std::vector<double> values(100, 1);
+            values[nan_ix] = nan;
+            values.back() = nan;
+
+            EXPECT_TRUE(std::isnan(k::min(values.data(), values.size())));
+            EXPECT_TRUE(std::isnan(k::max(values.data(), values.size())));
+            EXPECT_EQ(k::argmin(values.data(), values.size()), nan_ix);
+            EXPECT_EQ(k::argmax(values.data(), values.size()), nan_ix);
+        }
+
+        // infinities of both signs are not NaN
+        std::vector<double> values(100, 1);
+        values[10] = std::numeric_limits<double>::infinity();
+        values[11] = -std::numeric_limits<double>::infinity();
+        EXPECT_EQ(k::min(values.data(), values.size()), values[11]);
+        EXPECT_EQ(k::max(values.data(), values.size()), values[10]);
+    }
+}
+
+TEST_F(Kernels, compensated_sum) {
+    for (auto t : targets()) {
+        ASSERT_EQ(k::set_target(t), 0);
+        std::vector<double> values(1001, 1.0);
+        values[0] = 1e16;
+        values.push_back(-1e16);
+
+        // a naive sum loses every 1.0 added to 1e16
+        EXPECT_EQ(k::sum(values.data(), values.size()), 1000);
+    }
+}
+
+TEST_F(Kernels, mean_variance) {
+    for (auto t : targets()) {
+        ASSERT_EQ(k::set_target(t), 0);
+        std::vector<double> values;
+        for (int ix = 0; ix < 1000; ++ix) {
+            // a large offset makes a one pass variance lose precision
+            values.push_back(1e9 + (ix % 2 ? 1 : -1));
+        }
+        values.push_back(1e9);
+
+        EXPECT_DOUBLE_EQ(k::mean(values.data(), values.size()), 1e9);
+        EXPECT_NEAR(k::variance(values.data(), values.size()),
+                    1000.0 / 1001,
+                    1e-12);
+        EXPECT_NEAR(k::variance(values.data(),
+                                values.size(),
+                                sizeof(double),
+                                1),
+                    1.0,
+                    1e-12);
+    }
+}
+
+TEST_F(Kernels, strided) {
+    std::vector<std::int64_t> values(200);
+    for (std::size_t ix = 0; ix < values.size(); ++ix) {
+        // even indices hold 0..99, odd indices hold noise
+        values[ix] = ix % 2 ? -1000 : ix / 2;
+    }
+    py::ssize_t stride = 2 * sizeof(std::int64_t);
+
+    EXPECT_EQ(k::sum(values.data(), 100, stride), 4950);
+    EXPECT_EQ(k::min(values.data(), 100, stride), 0);
+    EXPECT_EQ(k::max(values.data(), 100, stride), 99);
+    EXPECT_EQ(k::argmin(values.data(), 100, stride), 0);
+    EXPECT_EQ(k::argmax(values.data(), 100, stride), 99);
+
+    std::vector<std::int64_t> out(100);
+    k::add(values.data(), stride, values.data(), stride, out.data(), 100);
+    for (std::size_t ix = 0; ix < out.size(); ++ix) {
+        EXPECT_EQ(out[ix], 2 * static_cast<std::int64_t>(ix));
+    }
+}
+
+TEST_F(Kernels, integer_overflow_wraps) {
+    std::vector<std::int32_t> values(100,
+                                     std::numeric_limits<std::int32_t>::max());
+    std::vector<std::int32_t> out(100);
+
+    k::add(values.data(), 4, values.data(), 4, out.data(), values.size());
+    EXPECT_EQ(out[0], -2);
+    EXPECT_EQ(k::sum(values.data(), 2), -2);
+}
+
+TEST_F(Kernels, buffer_view_reductions) {
+    auto ob = to_buffer(std::vector<double>{3, 1, 4, 1, 5, 9, 2, 6});
+    ASSERT_NONNULL(ob);
+    py::buffer_view<const double> view(ob);
+    ASSERT_TRUE(view.is_nonnull());
+    double out;
+
+    ASSERT_EQ(k::sum(view, out), 0);
+    EXPECT_EQ(out, 31);
+    ASSERT_EQ(k::min(view, out), 0);
+    EXPECT_EQ(out, 1);
+    ASSERT_EQ(k::max(view, out), 0);
+    EXPECT_EQ(out, 9);
+    EXPECT_EQ(k::argmin(view), 1);
+    EXPECT_EQ(k::argmax(view), 5);
+    ASSERT_EQ(k::mean(view, out), 0);
+    EXPECT_EQ(out, 31.0 / 8);
+    EXPECT_NO_PYTHON_ERR();
+}
+
+TEST_F(Kernels, buffer_view_empty) {
+    auto ob = to_buffer(std::vector<double>{});
+    ASSERT_NONNULL(ob);
+    py::buffer_view<const double> view(ob);
+    ASSERT_TRUE(view.is_nonnull());
+    double out;
+
+    ASSERT_EQ(k::sum(view, out), 0);
+    EXPECT_EQ(out, 0);
+
+    EXPECT_NE(k::min(view, out), 0);
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+    EXPECT_EQ(k::argmax(view), -1);
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+    EXPECT_NE(k::variance(view, out), 0);
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+}
+
+TEST_F(Kernels, buffer_view_elementwise) {
+    auto a_ob = to_buffer(std::vector<std::int32_t>{1, 2, 3, 4});
+    auto b_ob = to_buffer(std::vector<std::int32_t>{4, 3, 2, 1});
+    ASSERT_NONNULL(a_ob);
+    ASSERT_NONNULL(b_ob);
+    py::buffer_view<const std::int32_t> a(a_ob);
+    py::buffer_view<const std::int32_t> b(b_ob);
+
+    auto sum = k::add(a, b);
+    ASSERT_NONNULL(sum);
+    py::buffer_view<const std::int32_t> sum_view(sum);
+    ASSERT_TRUE(sum_view.is_nonnull());
+    for (py::ssize_t ix = 0; ix < 4; ++ix) {
+        EXPECT_EQ(sum_view[ix], 5);
+    }
+
+    auto product = k::mul(a, b);
+    ASSERT_NONNULL(product);
+    py::buffer_view<const std::int32_t> product_view(product);
+    ASSERT_TRUE(product_view.is_nonnull());
+    std::array<std::int32_t, 4> expected_product = {4, 6, 6, 4};
+    for (py::ssize_t ix = 0; ix < 4; ++ix) {
+        EXPECT_EQ(product_view[ix], expected_product[ix]);
+    }
+
+    auto less = k::compare(a, b, py::LT);
+    ASSERT_NONNULL(less);
+    py::buffer_view<const bool> less_view(less);
+    ASSERT_TRUE(less_view.is_nonnull());
+    std::array<bool, 4> expected_less = {true, true, false, false};
+    for (py::ssize_t ix = 0; ix < 4; ++ix) {
+        EXPECT_EQ(less_view[ix], expected_less[ix]);
+    }
+}
+
+TEST_F(Kernels, buffer_view_elementwise_empty) {
+    auto a_ob = to_buffer(std::vector<double>{});
+    auto b_ob = to_buffer(std::vector<double>{});
+    ASSERT_NONNULL(a_ob);
+    ASSERT_NONNULL(b_ob);
+    py::buffer_view<const double> a(a_ob);
+    py::buffer_view<const double> b(b_ob);
+
+    auto sum = k::add(a, b);
+    ASSERT_NONNULL(sum);
+    py::buffer_view<const double> sum_view(sum);
+    ASSERT_TRUE(sum_view.is_nonnull());
+    EXPECT_EQ(sum_view.shape(0), 0);
+
+    auto product = k::mul(a, b);
+    ASSERT_NONNULL(product);
+    EXPECT_TRUE(py::buffer_view<const double>(product).is_nonnull());
+
+    auto less = k::compare(a, b, py::LT);
+    ASSERT_NONNULL(less);
+    py::buffer_view<const bool> less_view(less);
+    ASSERT_TRUE(less_view.is_nonnull());
+    EXPECT_EQ(less_view.shape(0), 0);
+    EXPECT_NO_PYTHON_ERR();
+}
+
+TEST_F(Kernels, buffer_view_shape_mismatch) {
+    auto a_ob = to_buffer(std::vector<double>{1, 2, 3});
+    auto b_ob = to_buffer(std::vector<double>{1, 2});
+    ASSERT_NONNULL(a_ob);
+    ASSERT_NONNULL(b_ob);
+    py::buffer_view<const double> a(a_ob);
+    py::buffer_view<const double> b(b_ob);
+
+    EXPECT_IS(k::add(a, b), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+}
+
+TEST_F(Kernels, buffer_view_ndim) {
+    auto matrix_ob = to_buffer(std::vector<double>{1, 2, 3, 4, 5, 6},
+                               py::tuple::pack(2_p, 3_p));
+    ASSERT_NONNULL(matrix_ob);
+    py::buffer_view<const double, 2> matrix(matrix_ob);
+    ASSERT_TRUE(matrix.is_nonnull());
+    double out;
+
+    ASSERT_EQ(k::sum(matrix, out), 0);
+    EXPECT_EQ(out, 21);
+    EXPECT_EQ(k::argmax(matrix), 5);
+
+    auto doubled = k::add(matrix, matrix);
+    ASSERT_NONNULL(doubled);
+    py::buffer_view<const double, 2> doubled_view(doubled);
+    ASSERT_TRUE(doubled_view.is_nonnull());
+    EXPECT_EQ(doubled_view(1, 2), 12);
+}
@@ -1,6 +1,10 @@
 #include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <tuple>
 #include <typeinfo>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include <Python.h>
@@ -77,3 +81,318 @@ TEST(List, from_iterable_pyobject) {
         EXPECT_IS(elem, expected[n++]);
     }
 }
+
+TEST(List, from_iterable_list_and_tuple) {
+    auto expected = py::list::pack(0_p, 1_p, 2_p);
+    auto expected_tuple = py::tuple::from_iterable(expected);
+    ASSERT_NONNULL(expected_tuple);
+
+    for (const py::object &seq : {py::object(expected),
+                                  py::object(expected_tuple)}) {
+        auto ob = py::list::from_iterable(seq);
+        ASSERT_NONNULL(ob);
+        ASSERT_EQ(ob.len(), 3);
+
+        py::ssize_t n = 0;
+        for (const auto &elem : ob) {
+            EXPECT_IS(elem, expected[n++]);
+        }
+    }
+}
+
+TEST(List, from_iterable_unsized) {
+    struct subtest {
+        const char *source;
+        py::ssize_t start;
+        py::ssize_t len;
+    };
+
+    for (const auto &subtest : {
+            subtest{"(n for n in range(100))", 0, 100},
+            subtest{"iter(range(100))", 0, 100},
+            // 0 is falsey so this has no useful length hint
+            subtest{"filter(None, range(100))", 1, 99},
+            subtest{"(n for n in range(0))", 0, 0}}) {
+        auto gen = eval(subtest.source);
+        ASSERT_NONNULL(gen);
+
+        auto ob = py::list::from_iterable(gen);
+        ASSERT_NONNULL(ob);
+        ASSERT_EQ(ob.len(), subtest.len) << subtest.source;
+
+        py::ssize_t n = subtest.start;
+        for (const auto &elem : ob) {
+            EXPECT_EQ(PyLong_AsSsize_t(elem), n++);
+        }
+    }
+}
+
+TEST(List, from_iterable_raises) {
+    auto gen = eval("(1 // (5 - n) for n in range(10))");
+    ASSERT_NONNULL(gen);
+
+    EXPECT_IS(py::list::from_iterable(gen), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_ZeroDivisionError);
+
+    EXPECT_IS(py::list::from_iterable(1_p), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+}
+
+TEST(List, from_range) {
+    std::vector<double> values = {1.5, 1.5, 0.0, -0.0, 2.5};
+    auto ob = py::list::from_range(values);
+    ASSERT_NONNULL(ob);
+    ASSERT_EQ(ob.len(), 5);
+
+    for (std::size_t n = 0; n < values.size(); ++n) {
+        EXPECT_EQ(PyFloat_AsDouble(ob[n]), values[n]);
+    }
+    // repeated values share a single boxed object
+    EXPECT_IS(ob[0], ob[1]);
+    EXPECT_IS_NOT(ob[2], ob[3]);
+    EXPECT_TRUE(std::signbit(PyFloat_AsDouble(ob[3])));
+
+    std::array<std::int64_t, 4> ints = {1, 2, 1000, -1};
+    auto int_list = py::list::from_range(ints.data(), ints.size());
+    ASSERT_NONNULL(int_list);
+    ASSERT_EQ(int_list.len(), 4);
+    for (std::size_t n = 0; n < ints.size(); ++n) {
+        EXPECT_EQ(PyLong_AsLongLong(int_list[n]), ints[n]);
+    }
+    EXPECT_IS(int_list[0], 1_p);
+
+    std::vector<double> empty;
+    auto empty_list = py::list::from_range(empty);
+    ASSERT_NONNULL(empty_list);
+    EXPECT_EQ(empty_list.len(), 0);
+}
+
+TEST(List, extend) {
+    auto ob = py::list::pack(0_p);
+    ASSERT_NONNULL(ob);
+
+    for (int n = 0; n < 10; ++n) {
+        std::array<bool, 3> values = {true, false, false};
+        ASSERT_EQ(ob.extend(values), 0);
+    }
+    ASSERT_EQ(ob.len(), 31);
+    EXPECT_IS(ob[0], 0_p);
+    for (py::ssize_t n = 1; n < ob.len(); ++n) {
+        EXPECT_IS(ob[n], (n % 3 == 1) ? Py_True : Py_False);
+    }
+
+    py::list::object null;
+    std::array<int, 1> values = {1};
+    EXPECT_NE(null.extend(values), 0);
+    EXPECT_PYTHON_ERR(PyExc_AssertionError);
+}
+
+TEST(List, extend_too_large) {
+    auto ob = py::list::pack(0_p);
+    ASSERT_NONNULL(ob);
+
+    // the lengths are rejected before any element is read
+    const long *data = nullptr;
+    for (py::ssize_t len : {PY_SSIZE_T_MAX, PY_SSIZE_T_MAX - 1}) {
+        EXPECT_NE(ob.extend(data, len), 0);
+        EXPECT_PYTHON_ERR(PyExc_MemoryError);
+        EXPECT_EQ(ob.len(), 1);
+    }
+}
+
+TEST(List, to_vector) {
+    auto ob = eval("[1, 2.5, True, -(2 ** 53) - 1, 2 ** 62]");
+    ASSERT_NONNULL(ob);
+    py::list::object l(ob);
+
+    std::vector<double> doubles = {-1.0};
+    doubles.reserve(16);
+    const double *buffer = doubles.data();
+    ASSERT_EQ(l.to_vector(doubles), 0);
+    ASSERT_EQ(doubles.size(), 5ul);
+    EXPECT_EQ(doubles.data(), buffer);
+    EXPECT_EQ(doubles[0], 1.0);
+    EXPECT_EQ(doubles[1], 2.5);
+    EXPECT_EQ(doubles[2], 1.0);
+    EXPECT_EQ(doubles[3], -9007199254740992.0);
+    EXPECT_EQ(doubles[4], 4611686018427387904.0);
+
+    // floats are not truncated into ints
+    std::vector<std::int64_t> ints;
+    EXPECT_NE(l.to_vector(ints), 0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+
+    auto int_ob = eval("[0, 255, -1, 2 ** 63 - 1]");
+    ASSERT_NONNULL(int_ob);
+    py::list::object int_list(int_ob);
+
+    ASSERT_EQ(int_list.to_vector(ints), 0);
+    EXPECT_EQ(ints, (std::vector<std::int64_t>{
+                0, 255, -1, std::numeric_limits<std::int64_t>::max()}));
+
+    struct subtest {
+        const char *source;
+        PyObject *exc;
+    };
+
+    for (const auto &subtest : {
+            subtest{"[0, 2 ** 63]", PyExc_OverflowError},
+            subtest{"[0, -(2 ** 63) - 1]", PyExc_OverflowError},
+            subtest{"[0, 'a']", PyExc_TypeError}}) {
+        auto bad = eval(subtest.source);
+        ASSERT_NONNULL(bad);
+        EXPECT_NE(py::list::object(bad).to_vector(ints), 0) << subtest.source;
+        EXPECT_PYTHON_ERR(subtest.exc);
+    }
+
+    std::vector<std::uint8_t> bytes;
+    ASSERT_EQ(py::list::object(eval("[0, 255]")).to_vector(bytes), 0);
+    EXPECT_EQ(bytes, (std::vector<std::uint8_t>{0, 255}));
+    for (const char *source : {"[256]", "[-1]", "[2 ** 64]"}) {
+        EXPECT_NE(py::list::object(eval(source)).to_vector(bytes), 0)
+            << source;
+        EXPECT_PYTHON_ERR(PyExc_OverflowError);
+    }
+
+    std::vector<std::uint64_t> words;
+    ASSERT_EQ(py::list::object(eval("[2 ** 64 - 1]")).to_vector(words), 0);
+    EXPECT_EQ(words[0], std::numeric_limits<std::uint64_t>::max());
+}
+
+TEST(List, sort_native) {
+    struct subtest {
+        const char *source;
+        bool parallel;
+    };
+
+    for (const auto &subtest : {
+            subtest{"[]", false},
+            subtest{"[3.5, -1.0, 0.0, -0.0, 2.25, float('inf')]", false},
+            subtest{"[5, -3, 2 ** 62, -(2 ** 63), 0, 5]", false},
+            // long enough to be radix sorted
+            subtest{"[(n * 7919) % 4001 - 2000 for n in range(5000)]", false},
+            subtest{"['b', 'a', 'ab', '', '\\u1234', '\\U0001f600', 'a\\xe9']",
+                    false},
+            // mixed types and unsupported values use list.sort
+            subtest{"[2, 1.5, True, 0]", false},
+            subtest{"[2 ** 70, 1, -(2 ** 70)]", false},
+            subtest{"[(n * 7919) % 100003 for n in range(100003)]", true},
+            subtest{"[((n * 7919) % 100003) / 7 for n in range(100003)]",
+                    true}}) {
+        auto ob = eval(subtest.source);
+        ASSERT_NONNULL(ob);
+        py::list::object l(ob);
+        auto expected = py::list::from_iterable(l);
+        ASSERT_NONNULL(expected);
+        ASSERT_EQ(PyList_Sort(expected), 0);
+
+        int status = subtest.parallel ?
+            py::list::sort_native_parallel(l, 4) :
+            py::list::sort_native(l);
+        ASSERT_EQ(status, 0) << subtest.source;
+        ASSERT_EQ(l.len(), expected.len());
+        for (py::ssize_t n = 0; n < l.len(); ++n) {
+            // the sort is stable so equal elements keep their identity
+            EXPECT_IS(l[n], expected[n]) << subtest.source << " at " << n;
+        }
+    }
+
+    auto with_nan = eval("[float('nan'), 1.0, 0.0]");
+    ASSERT_NONNULL(with_nan);
+    EXPECT_EQ(py::list::sort_native(with_nan), 0);
+
+    EXPECT_NE(py::list::sort_native(py::list::object()), 0);
+    EXPECT_PYTHON_ERR(PyExc_AssertionError);
+}
+
+TEST(List, pack_references) {
+    auto a = eval("object()");
+    ASSERT_NONNULL(a);
+    py::ssize_t start = Py_REFCNT(a);
+
+    {
+        auto l = py::list::pack(a, a.str());
+        ASSERT_NONNULL(l);
+        EXPECT_EQ(Py_REFCNT(a), start + 1);
+        EXPECT_IS(l[0], a);
+        EXPECT_EQ(Py_REFCNT(l[1]), 1);
+    }
+    EXPECT_EQ(Py_REFCNT(a), start);
+}
+
+TEST(List, of) {
+    auto ob = eval("[1.5, 2.5, 3.5]");
+    ASSERT_NONNULL(ob);
+
+    py::list::of<double> view(ob);
+    ASSERT_TRUE(view.is_nonnull());
+    EXPECT_IS(view.list(), ob);
+    EXPECT_EQ(view.values(), (std::vector<double>{1.5, 2.5, 3.5}));
+    EXPECT_FALSE(view.changed());
+
+    // an unchanged list is not unboxed again
+    const double *data = view.data();
+    ASSERT_EQ(view.update(ob), 0);
+    EXPECT_EQ(view.data(), data);
+
+    // replacing an item is detected even when the list's size is the same
+    auto replacement = eval("4.5");
+    ASSERT_NONNULL(replacement);
+    ASSERT_EQ(PyList_SetItem(ob, 1, replacement.incref()), 0);
+    EXPECT_TRUE(view.changed());
+    ASSERT_EQ(view.update(), 0);
+    EXPECT_EQ(view.values(), (std::vector<double>{1.5, 4.5, 3.5}));
+
+    ASSERT_EQ(PyList_Append(ob, 0_p), 0);
+    EXPECT_TRUE(view.changed());
+    EXPECT_NE(view.update(), 0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+    EXPECT_FALSE(view.is_nonnull());
+
+    auto ints = eval("[1, 2, 3]");
+    ASSERT_NONNULL(ints);
+    py::list::of<std::int64_t> int_view(ints);
+    ASSERT_TRUE(int_view.is_nonnull());
+    EXPECT_EQ(int_view.values(), (std::vector<std::int64_t>{1, 2, 3}));
+
+    ASSERT_EQ(int_view.update(eval("[]")), 0);
+    EXPECT_EQ(int_view.size(), 0);
+    EXPECT_FALSE(int_view.changed());
+
+    EXPECT_NE(int_view.update(1_p), 0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+}
+
+TEST(List, slice) {
+    auto ob = eval("list(range(10))");
+    ASSERT_NONNULL(ob);
+    py::list::object l(ob);
+
+    auto span = l.slice(1, -1, 2);
+    ASSERT_TRUE(span.is_nonnull());
+    ASSERT_EQ(span.size(), 4);
+    std::vector<long> values;
+    for (const py::object &item : span) {
+        values.push_back(PyLong_AsLong(item));
+    }
+    EXPECT_EQ(values, (std::vector<long>{1, 3, 5, 7}));
+
+    auto copy = l.slice_copy(1, -1, 2);
+    ASSERT_NONNULL(copy);
+    EXPECT_TRUE(PyList_CheckExact(copy.operator PyObject*()));
+    EXPECT_TRUE((copy == eval("[1, 3, 5, 7]")).istrue());
+
+    auto tuple_copy = l.slice<-2>().to_tuple();
+    ASSERT_NONNULL(tuple_copy);
+    EXPECT_TRUE((tuple_copy == eval("(8, 9)")).istrue());
+
+    EXPECT_EQ(PyLong_AsLong(l.at<-2>()), 8);
+    EXPECT_IS(py::list::object().slice_copy(0), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_AssertionError);
+    // the items of an empty list are null
+    py::tmpref<py::list::object> empty(PyList_New(0));
+    ASSERT_NONNULL(empty);
+    auto reversed = empty.slice_copy(-100, py::slice_end, -1);
+    ASSERT_NONNULL(reversed);
+    EXPECT_TRUE((reversed == eval("[]")).istrue());
+}
@@ -1,6 +1,7 @@
 #include <limits>
 #include <type_traits>
 #include <typeinfo>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -127,3 +128,204 @@ TEST(Long, check) {
     EXPECT_TRUE(py::long_::check(m.as_nonnull()));
     EXPECT_TRUE(py::long_::checkexact(m.as_nonnull()));
 }
+
+TEST(Long, read_small_int) {
+    for (const char *source : {"0", "1", "-1", "2 ** 30 - 1", "2 ** 30",
+                               "-(2 ** 30)", "2 ** 60 - 1", "-(2 ** 60 - 1)"}) {
+        auto ob = eval(source);
+        ASSERT_NONNULL(ob);
+
+        long long value;
+        ASSERT_TRUE(py::read_small_int(ob, value)) << source;
+        EXPECT_EQ(value, py::long_::object(ob).as_long_long()) << source;
+        EXPECT_NO_PYTHON_ERR();
+    }
+
+    for (const char *source : {"2 ** 60", "-(2 ** 60)", "2 ** 100"}) {
+        auto ob = eval(source);
+        ASSERT_NONNULL(ob);
+
+        long long value;
+        EXPECT_FALSE(py::read_small_int(ob, value)) << source;
+        EXPECT_NO_PYTHON_ERR();
+    }
+}
+
+TEST(Long, as_small_out_of_range) {
+    auto ob = eval("-1");
+    ASSERT_NONNULL(ob);
+
+    // small values which do not fit still raise from the C API
+    EXPECT_EQ(py::long_::object(ob).as_unsigned_long(),
+              static_cast<unsigned long>(-1));
+    EXPECT_PYTHON_ERR(PyExc_OverflowError);
+
+    auto big = eval("2 ** 59");
+    ASSERT_NONNULL(big);
+    EXPECT_EQ(py::long_::object(big).as_double(), 576460752303423488.0);
+    EXPECT_NO_PYTHON_ERR();
+}
+
+namespace {
+/**
+   Check that an operator on `long_::object` gives the same result as the
+   number protocol, including when the number protocol raises.
+*/
+template<typename F>
+void check_operator(const char *name,
+                    PyObject *expected_func(PyObject*, PyObject*),
+                    F f,
+                    const std::vector<const char*> &lhs,
+                    const std::vector<const char*> &rhs) {
+    for (const char *a_source : lhs) {
+        for (const char *b_source : rhs) {
+            auto a = eval(a_source);
+            auto b = eval(b_source);
+            ASSERT_NONNULL(a);
+            ASSERT_NONNULL(b);
+
+            py::tmpref<py::object> expected(expected_func(a, b));
+            PyObject *expected_err = PyErr_Occurred();
+            PyErr_Clear();
+
+            auto result = f(py::long_::object(a), py::long_::object(b));
+            if (!expected.is_nonnull()) {
+                EXPECT_IS(result, nullptr) << a_source << name << b_source;
+                EXPECT_TRUE(PyErr_ExceptionMatches(expected_err));
+                PyErr_Clear();
+                continue;
+            }
+            ASSERT_NONNULL(result) << a_source << name << b_source;
+            EXPECT_TRUE((result == expected).istrue())
+                << a_source << name << b_source;
+        }
+    }
+}
+}
+
+TEST(Long, small_operators) {
+    std::vector<const char*> values = {"0", "1", "-1", "7", "-3",
+                                       "2 ** 30", "-(2 ** 30)",
+                                       "2 ** 59", "-(2 ** 59)",
+                                       "2 ** 60 - 1", "2 ** 100"};
+    std::vector<const char*> shifts = {"0", "1", "3", "-1", "59", "63",
+                                       "64", "100"};
+
+    check_operator(" + ", PyNumber_Add,
+                   [](const auto &a, const auto &b) { return a + b; },
+                   values, values);
+    check_operator(" - ", PyNumber_Subtract,
+                   [](const auto &a, const auto &b) { return a - b; },
+                   values, values);
+    check_operator(" * ", PyNumber_Multiply,
+                   [](const auto &a, const auto &b) { return a * b; },
+                   values, values);
+    check_operator(" % ", PyNumber_Remainder,
+                   [](const auto &a, const auto &b) { return a % b; },
+                   values, values);
+    check_operator(" & ", PyNumber_And,
+                   [](const auto &a, const auto &b) { return a & b; },
+                   values, values);
+    check_operator(" ^ ", PyNumber_Xor,
+                   [](const auto &a, const auto &b) { return a ^ b; },
+                   values, values);
+    check_operator(" | ", PyNumber_Or,
+                   [](const auto &a, const auto &b) { return a | b; },
+                   values, values);
+    check_operator(" << ", PyNumber_Lshift,
+                   [](const auto &a, const auto &b) { return a << b; },
+                   values, shifts);
+    check_operator(" >> ", PyNumber_Rshift,
+                   [](const auto &a, const auto &b) { return a >> b; },
+                   values, shifts);
+}
+
+TEST(Long, small_operators_cached) {
+    // small results come from the small int cache instead of allocating
+    auto ob = py::long_::object(1_p) + 2_p;
+    ASSERT_NONNULL(ob);
+    EXPECT_IS(ob, 3_p);
+
+    auto big = eval("-(2 ** 59)");
+    auto five = eval("5");
+    auto neg_five = eval("-5");
+    auto four = eval("4");
+    ASSERT_TRUE(pyutils::all_nonnull(big, five, neg_five, four));
+
+    auto neg = -py::long_::object(big);
+    ASSERT_NONNULL(neg);
+    auto expected = eval("2 ** 59");
+    EXPECT_TRUE((neg == expected).istrue());
+    EXPECT_IS(py::long_::object(neg_five).abs(), five);
+    EXPECT_IS(py::long_::object(four).invert(), neg_five);
+}
+
+#ifdef __SIZEOF_INT128__
+TEST(Long, int128) {
+    __int128 big = static_cast<__int128>(1) << 100;
+    std::vector<std::pair<__int128, const char*>> cases = {
+        {0, "0"},
+        {-1, "-1"},
+        {big + 3, "2 ** 100 + 3"},
+        {-big, "-(2 ** 100)"},
+        {std::numeric_limits<__int128>::max(), "2 ** 127 - 1"},
+        {std::numeric_limits<__int128>::min(), "-(2 ** 127)"},
+    };
+    for (const auto &[value, source] : cases) {
+        auto expected = eval(source);
+        ASSERT_NONNULL(expected);
+
+        auto ob = py::long_::from_int128(value);
+        ASSERT_NONNULL(ob);
+        EXPECT_TRUE((ob == expected).istrue()) << source;
+        EXPECT_TRUE(ob.as_int128() == value) << source;
+        EXPECT_NO_PYTHON_ERR();
+    }
+
+    auto max = py::long_::from_uint128(~static_cast<unsigned __int128>(0));
+    ASSERT_NONNULL(max);
+    auto expected = eval("2 ** 128 - 1");
+    ASSERT_NONNULL(expected);
+    EXPECT_TRUE((max == expected).istrue());
+    EXPECT_TRUE(max.as_uint128() == ~static_cast<unsigned __int128>(0));
+    EXPECT_NO_PYTHON_ERR();
+
+    EXPECT_TRUE(max.as_int128() == -1);
+    EXPECT_PYTHON_ERR(PyExc_OverflowError);
+
+    auto negative = eval("-1");
+    ASSERT_NONNULL(negative);
+    EXPECT_TRUE(py::long_::object(negative).as_uint128() ==
+                static_cast<unsigned __int128>(-1));
+    EXPECT_PYTHON_ERR(PyExc_OverflowError);
+}
+#endif
+
+TEST(Long, bytes) {
+    auto ob = eval("-(2 ** 70) + 5");
+    ASSERT_NONNULL(ob);
+    py::long_::object n(ob);
+
+    py::ssize_t len = n.byte_length();
+    ASSERT_EQ(len, 9);
+
+    for (bool little_endian : {true, false}) {
+        std::vector<unsigned char> buffer(len);
+        ASSERT_EQ(n.to_bytes(buffer.data(), len, little_endian), 0);
+
+        auto back = py::long_::from_bytes(buffer.data(), len, little_endian);
+        ASSERT_NONNULL(back);
+        EXPECT_TRUE((back == n).istrue());
+
+        EXPECT_NE(n.to_bytes(buffer.data(), len - 1, little_endian), 0);
+        EXPECT_PYTHON_ERR(PyExc_OverflowError);
+    }
+
+    std::vector<unsigned char> buffer(len);
+    EXPECT_NE(n.to_bytes(buffer.data(), len, true, false), 0);
+    EXPECT_PYTHON_ERR(PyExc_OverflowError);
+
+    const unsigned char bytes[] = {0x01, 0x02};
+    auto unsigned_ob = py::long_::from_bytes(bytes, 2, false, false);
+    EXPECT_TRUE((unsigned_ob == 258_p).istrue());
+}
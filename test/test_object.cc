@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <sstream>
 #include <type_traits>
 #include <unordered_map>
@@ -102,3 +103,101 @@ TEST_F(Object, setattr_delattr) {
     ASSERT_EQ(this->C.delattr("test"_p), 0);
     EXPECT_FALSE(this->C.hasattr("test"_p));
 }
+
+TEST_F(Object, integer_index) {
+    struct subtest {
+        const char *source;
+        py::ssize_t ix;
+        const char *expected;
+    };
+
+    for (const auto &subtest : {
+            subtest{"[1, 2, 3]", 0, "1"},
+            subtest{"[1, 2, 3]", -1, "3"},
+            subtest{"(1, 2, 3)", 1, "2"},
+            subtest{"(1, 2, 3)", -3, "1"},
+            subtest{"range(10, 20)", -2, "18"},
+            subtest{"'abc'", 2, "'c'"},
+            subtest{"{1: 'a', -1: 'b'}", -1, "'b'"},
+            subtest{"__import__('collections').UserDict({-1: 'x'})",
+                    -1,
+                    "'x'"}}) {
+        auto ob = eval(subtest.source);
+        ASSERT_NONNULL(ob);
+        auto expected = eval(subtest.expected);
+        ASSERT_NONNULL(expected);
+
+        auto item = ob[subtest.ix];
+        ASSERT_NONNULL(item) << subtest.source;
+        EXPECT_TRUE((item == expected).istrue()) << subtest.source;
+        EXPECT_TRUE((ob.getitem(static_cast<int>(subtest.ix)) ==
+                     expected).istrue()) << subtest.source;
+    }
+
+    for (const char *source : {"[1, 2]", "(1, 2)", "range(2)"}) {
+        auto ob = eval(source);
+        ASSERT_NONNULL(ob);
+        EXPECT_IS(ob[2], nullptr) << source;
+        EXPECT_PYTHON_ERR(PyExc_IndexError);
+        EXPECT_IS(ob[-3], nullptr) << source;
+        EXPECT_PYTHON_ERR(PyExc_IndexError);
+    }
+
+    EXPECT_IS(py::object()[0], nullptr);
+    EXPECT_PYTHON_ERR(PyExc_AssertionError);
+}
+
+TEST_F(Object, integer_setitem) {
+    auto l = eval("[1, 2, 3]");
+    ASSERT_NONNULL(l);
+
+    ASSERT_EQ(l.setitem(-1, 4_p), 0);
+    ASSERT_EQ(l.setitem(0, 5_p), 0);
+    ASSERT_EQ(l.delitem(1), 0);
+    EXPECT_TRUE((l == eval("[5, 4]")).istrue());
+
+    EXPECT_NE(l.setitem(2, 1_p), 0);
+    EXPECT_PYTHON_ERR(PyExc_IndexError);
+    EXPECT_NE(l.setitem(-3, 1_p), 0);
+    EXPECT_PYTHON_ERR(PyExc_IndexError);
+
+    auto t = eval("(1, 2)");
+    ASSERT_NONNULL(t);
+    EXPECT_NE(t.setitem(0, 1_p), 0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+
+    auto d = eval("{}");
+    ASSERT_NONNULL(d);
+    ASSERT_EQ(d.setitem(-1, 1_p), 0);
+    EXPECT_TRUE((d == eval("{-1: 1}")).istrue());
+    ASSERT_EQ(d.delitem(-1), 0);
+    EXPECT_TRUE((d == eval("{}")).istrue());
+
+    auto ud = eval("__import__('collections').UserDict()");
+    ASSERT_NONNULL(ud);
+    ASSERT_EQ(ud.setitem(-1, 1_p), 0);
+    EXPECT_TRUE((ud == eval("{-1: 1}")).istrue());
+    ASSERT_EQ(ud.delitem(-1), 0);
+    EXPECT_TRUE((ud == eval("{}")).istrue());
+}
+
+TEST_F(Object, unsigned_key_above_ssize_max) {
+    std::uint64_t key = std::uint64_t(1) << 63;
+
+    auto d = eval("{}");
+    ASSERT_NONNULL(d);
+    ASSERT_EQ(d.setitem(key, 1_p), 0);
+    EXPECT_TRUE((d == eval("{2 ** 63: 1}")).istrue());
+    EXPECT_IS(d[key], 1_p);
+    EXPECT_IS(py::ops<py::policy::propagate>::getitem(d, key), 1_p);
+    ASSERT_EQ(d.delitem(key), 0);
+    EXPECT_TRUE((d == eval("{}")).istrue());
+
+    // the key must not wrap around to -1 and read the last element
+    auto l = eval("[1, 2, 3]");
+    ASSERT_NONNULL(l);
+    EXPECT_IS(l[std::uint64_t(-1)], nullptr);
+    EXPECT_PYTHON_ERR(PyExc_IndexError);
+    EXPECT_NE(l.setitem(std::uint64_t(-1), 1_p), 0);
+    EXPECT_PYTHON_ERR(PyExc_IndexError);
+}
@@ -0,0 +1,153 @@
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include <Python.h>
+
+#include "libpy/automethod.h"
+#include "libpy/libpy.h"
+#include "utils.h"
+
+using py::operator""_p;
+
+TEST(Policy, propagate) {
+    auto l = eval("[1, 2]");
+    ASSERT_NONNULL(l);
+
+    using ops = py::ops<py::policy::propagate>;
+    auto item = ops::getitem(l, 1);
+    ASSERT_NONNULL(item);
+    EXPECT_IS(item, 2_p);
+
+    EXPECT_IS(ops::getitem(l, 2), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_IndexError);
+
+    EXPECT_NE(ops::setitem(l, 5, 1_p), 0);
+    EXPECT_PYTHON_ERR(PyExc_IndexError);
+
+    EXPECT_IS(ops::getattr(l, "x"_p), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_AttributeError);
+}
+
+TEST(Policy, throws) {
+    auto l = eval("[1, 2]");
+    ASSERT_NONNULL(l);
+
+    using ops = py::ops<py::policy::throws>;
+    auto append = ops::getattr(l, "append"_p);
+    ops::call(append, 3_p);
+    EXPECT_EQ(ops::setitem(l, 0, 4_p), 0);
+    EXPECT_IS(ops::getitem(l, -1), 3_p);
+    EXPECT_IS(ops::getitem(l, 0), 4_p);
+
+    try {
+        ops::getitem(l, 3);
+        FAIL() << "no exception thrown";
+    }
+    catch (py::error_already_set &e) {
+        // the Python exception is held by the C++ exception
+        EXPECT_NO_PYTHON_ERR();
+        EXPECT_TRUE(e.matches(py::err::IndexError));
+        e.restore();
+        EXPECT_PYTHON_ERR(PyExc_IndexError);
+    }
+
+    // null operands are checked once, on entry
+    try {
+        ops::getattr(py::object(nullptr), "x"_p);
+        FAIL() << "no exception thrown";
+    }
+    catch (py::error_already_set &e) {
+        EXPECT_TRUE(e.matches(PyExc_AssertionError));
+    }
+
+    // a null value deletes the item
+    auto d = eval("{'k': 1}");
+    ASSERT_NONNULL(d);
+    EXPECT_EQ(ops::setitem(d, "k"_p, py::object(nullptr)), 0);
+    EXPECT_EQ(PyDict_Size(d), 0);
+
+    // a failure without a Python exception still throws
+    EXPECT_THROW(py::check<py::policy::throws>(py::object(nullptr)),
+                 py::error_already_set);
+    EXPECT_NO_PYTHON_ERR();
+}
+
+TEST(Policy, check) {
+    PyErr_SetString(PyExc_ValueError, "failed");
+    EXPECT_THROW(py::check<py::policy::throws>(-1), py::error_already_set);
+    EXPECT_NO_PYTHON_ERR();
+
+    // -1 is not a failure unless an exception is raised
+    EXPECT_EQ(py::check<py::policy::throws>(-1), -1);
+    EXPECT_EQ(py::check<py::policy::propagate>(0), 0);
+}
+
+TEST(Policy, unchecked) {
+    auto t = eval("(1, 'a')");
+    ASSERT_NONNULL(t);
+
+    using ops = py::ops<py::policy::unchecked>;
+    EXPECT_IS(ops::getitem(t, 0), 1_p);
+    EXPECT_TRUE((ops::getitem(t, -1) == "a"_p).istrue());
+
+    auto d = eval("{}");
+    ASSERT_NONNULL(d);
+    EXPECT_EQ(ops::setitem(d, "k"_p, 1_p), 0);
+    EXPECT_IS(ops::getitem(d, "k"_p), 1_p);
+
+    // integral keys use the same lookup as `getitem_index`
+    EXPECT_EQ(ops::setitem(d, -1, 2_p), 0);
+    EXPECT_IS(ops::getitem(d, -1), 2_p);
+    EXPECT_EQ(PyDict_Size(d), 2);
+
+    auto len = eval("len");
+    ASSERT_NONNULL(len);
+    EXPECT_TRUE((ops::call(len, d) == 2_p).istrue());
+}
+
+namespace {
+py::tmpref<py::object> first(PyObject*, py::object seq) {
+    return py::ops<py::policy::throws>::getitem(seq, 0);
+}
+
+PyMethodDef first_def = automethod(first);
+
+int cxx_error(PyObject*) {
+    throw std::runtime_error("C++ failure");
+}
+
+PyMethodDef cxx_error_def = automethod(cxx_error);
+
+int unknown_error(PyObject*) {
+    throw 1;
+}
+
+PyMethodDef unknown_error_def = automethod(unknown_error);
+}
+
+TEST(Policy, automethod) {
+    py::tmpref<py::object> f(PyCFunction_New(&first_def, nullptr));
+    ASSERT_NONNULL(f);
+
+    auto l = eval("[5]");
+    ASSERT_NONNULL(l);
+    auto result = f(l);
+    ASSERT_NONNULL(result);
+    EXPECT_IS(result, 5_p);
+
+    auto empty = eval("[]");
+    ASSERT_NONNULL(empty);
+    EXPECT_IS(f(empty), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_IndexError);
+
+    py::tmpref<py::object> g(PyCFunction_New(&cxx_error_def, nullptr));
+    ASSERT_NONNULL(g);
+    EXPECT_IS(g(), nullptr);
+    EXPECT_PYTHON_ERR_MSG(PyExc_RuntimeError, "C++ failure"_p);
+
+    py::tmpref<py::object> h(PyCFunction_New(&unknown_error_def, nullptr));
+    ASSERT_NONNULL(h);
+    EXPECT_IS(h(), nullptr);
+    EXPECT_PYTHON_ERR_MSG(PyExc_RuntimeError,
+                          "unknown C++ exception was thrown"_p);
+}
@@ -0,0 +1,132 @@
+#include <array>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include <Python.h>
+
+#include "libpy/libpy.h"
+#include "utils.h"
+
+using py::operator""_p;
+
+TEST(Set, type) {
+    ASSERT_EQ(static_cast<PyObject*>(py::set::type),
+              reinterpret_cast<PyObject*>(&PySet_Type));
+    ASSERT_EQ(static_cast<PyObject*>(py::set::frozenset_type),
+              reinterpret_cast<PyObject*>(&PyFrozenSet_Type));
+
+    auto s = py::set::type();
+    EXPECT_EQ(static_cast<PyObject*>(s.type()),
+              reinterpret_cast<PyObject*>(&PySet_Type));
+
+    auto f = py::set::frozenset_type();
+    EXPECT_EQ(static_cast<PyObject*>(f.type()),
+              reinterpret_cast<PyObject*>(&PyFrozenSet_Type));
+}
+
+TEST(Set, from_non_set) {
+    py::set::object s(1_p);
+
+    EXPECT_IS(s, nullptr);
+    EXPECT_PYTHON_ERR(py::err::TypeError);
+}
+
+TEST(Set, from_iterable_list) {
+    auto l = py::list::pack(0_p, 1_p, 1_p, 2_p, 0_p);
+
+    for (auto s : {py::set::from_iterable(l),
+                   py::set::frozenset_from_iterable(l)}) {
+        ASSERT_NONNULL(s);
+        EXPECT_EQ(s.len(), 3);
+        for (const auto &n : {0_p, 1_p, 2_p}) {
+            EXPECT_EQ(s.contains(n), 1);
+        }
+        EXPECT_EQ(s.contains(3_p), 0);
+    }
+    EXPECT_EQ(py::set::checkexact(py::set::from_iterable(l)), 1);
+    EXPECT_EQ(PyFrozenSet_CheckExact(static_cast<PyObject*>(
+                  py::set::frozenset_from_iterable(l))), 1);
+}
+
+TEST(Set, from_iterable_non_pyobject) {
+    std::vector<py::object> elems = {"a"_p, "b"_p, "a"_p};
+    auto s = py::set::from_iterable(elems);
+    ASSERT_NONNULL(s);
+
+    EXPECT_EQ(s.len(), 2);
+    EXPECT_EQ(s.contains("a"_p), 1);
+    EXPECT_EQ(s.contains("b"_p), 1);
+}
+
+TEST(Set, from_iterable_unhashable) {
+    auto unhashable = py::list::pack(1_p);
+    std::vector<py::object> elems = {0_p, unhashable};
+    auto s = py::set::from_iterable(elems);
+
+    EXPECT_IS(s, nullptr);
+    EXPECT_PYTHON_ERR(py::err::TypeError);
+}
+
+TEST(Set, add_discard_update) {
+    auto s = py::set::from_iterable(std::array<py::object, 0>{});
+    ASSERT_NONNULL(s);
+
+    ASSERT_EQ(s.add(1_p), 0);
+    EXPECT_EQ(s.len(), 1);
+
+    std::array<py::object, 3> elems = {1_p, 2_p, 3_p};
+    ASSERT_EQ(s.update(elems), 0);
+    EXPECT_EQ(s.len(), 3);
+
+    ASSERT_EQ(s.update(py::list::pack(4_p, 5_p)), 0);
+    EXPECT_EQ(s.len(), 5);
+
+    EXPECT_EQ(s.discard(1_p), 1);
+    EXPECT_EQ(s.discard(1_p), 0);
+    EXPECT_EQ(s.as_nonnull().len(), 4);
+    EXPECT_NO_PYTHON_ERR();
+}
+
+TEST(Set, update_shrinking_list) {
+    // hashing the first element empties the list being added
+    auto make = eval(
+        "lambda l: type('shrink', (), {"
+        "    '__hash__': lambda self: (l.clear(), 0)[1],"
+        "})");
+    ASSERT_NONNULL(make);
+    auto l = eval("[]");
+    ASSERT_NONNULL(l);
+    auto cls = make(l);
+    ASSERT_NONNULL(cls);
+    for (int n = 0; n < 3; ++n) {
+        auto elem = cls();
+        ASSERT_NONNULL(elem);
+        ASSERT_EQ(PyList_Append(l, elem), 0);
+    }
+
+    auto s = py::set::from_iterable(std::array<py::object, 0>{});
+    ASSERT_NONNULL(s);
+    ASSERT_EQ(s.update(py::list::object(l)), 0);
+    EXPECT_EQ(s.len(), 1);
+    EXPECT_EQ(PyList_GET_SIZE(static_cast<PyObject*>(l)), 0);
+}
+
+TEST(Set, iteration_hashed_keys) {
+    auto s = py::set::from_iterable(py::list::pack("a"_p, "b"_p, "c"_p));
+    ASSERT_NONNULL(s);
+    py::tmpref<py::dict::object> d(3);
+    ASSERT_NONNULL(d);
+
+    std::size_t n = 0;
+    for (const auto &key : s) {
+        EXPECT_EQ(key.hash(), key.key().hash());
+        EXPECT_EQ(s.contains(key.key()), 1);
+        ASSERT_EQ(d.setitem(key, 1_p), 0);
+        ++n;
+    }
+    EXPECT_EQ(n, 3u);
+
+    for (const auto &key : {"a"_p, "b"_p, "c"_p}) {
+        EXPECT_IS(d[key], 1_p);
+    }
+}
@@ -0,0 +1,126 @@
+#include <sstream>
+#include <string_view>
+#include <type_traits>
+
+#include "gtest/gtest.h"
+#include <Python.h>
+
+#include "libpy/libpy.h"
+#include "utils.h"
+
+using py::operator""_p;
+
+TEST(Str, type) {
+    ASSERT_EQ(static_cast<PyObject*>(py::str::type),
+              reinterpret_cast<PyObject*>(&PyUnicode_Type));
+    auto s = py::str::type();
+
+    EXPECT_EQ(static_cast<PyObject*>(s.type()),
+              reinterpret_cast<PyObject*>(&PyUnicode_Type));
+}
+
+TEST(Str, from_non_str) {
+    py::str::object s(1_p);
+
+    EXPECT_IS(s, nullptr);
+    EXPECT_PYTHON_ERR(py::err::TypeError);
+}
+
+TEST(Str, from_string_view) {
+    auto s = py::str::object(std::string_view("ayy lmao")).as_tmpref();
+    ASSERT_NONNULL(s);
+
+    EXPECT_TRUE((s == "ayy lmao"_p).istrue());
+    EXPECT_EQ(s.len(), 8);
+}
+
+TEST(Str, as_string_view) {
+    py::str::object s("ayy lmao"_p);
+    std::string_view cs = s.as_string_view();
+
+    EXPECT_EQ(cs, "ayy lmao");
+    // ascii strings are their own utf-8 representation
+    EXPECT_EQ(static_cast<const void*>(cs.data()),
+              PyUnicode_DATA(static_cast<PyObject*>(s)));
+}
+
+TEST(Str, as_string_view_non_ascii) {
+    auto s = py::str::object(std::string_view("\xc3\xa9t\xc3\xa9")).as_tmpref();
+    ASSERT_NONNULL(s);
+    std::string_view cs = s.as_string_view();
+
+    EXPECT_EQ(cs, "\xc3\xa9t\xc3\xa9");
+    EXPECT_EQ(s.len(), 3);
+    // the utf-8 is cached so the second call returns the same buffer
+    EXPECT_EQ(cs.data(), s.as_string_view().data());
+}
+
+TEST(Str, kind) {
+    struct subtest {
+        const char *cs;
+        py::str::kind kind;
+    };
+
+    for (const auto &subtest : {subtest{"a", py::str::kind::ucs1},
+                                subtest{"\xc3\xa9", py::str::kind::ucs1},
+                                subtest{"\xe2\x82\xac", py::str::kind::ucs2},
+                                subtest{"\xf0\x9f\x98\x80",
+                                        py::str::kind::ucs4}}) {
+        auto s = py::str::object(std::string_view(subtest.cs)).as_tmpref();
+        ASSERT_NONNULL(s);
+        EXPECT_EQ(s.kind(), subtest.kind) << subtest.cs;
+    }
+}
+
+TEST(Str, view) {
+    // "a€b"
+    auto s = py::str::object(std::string_view("a\xe2\x82\xac" "b")).as_tmpref();
+    ASSERT_NONNULL(s);
+    ASSERT_EQ(s.kind(), py::str::kind::ucs2);
+
+    auto view = s.view<Py_UCS2>();
+    ASSERT_EQ(view.size(), 3);
+    EXPECT_EQ(view[0], 'a');
+    EXPECT_EQ(view[1], 0x20ac);
+    EXPECT_EQ(view[2], 'b');
+
+    auto wrong = s.view<Py_UCS1>();
+    EXPECT_EQ(wrong.data(), nullptr);
+    EXPECT_EQ(wrong.size(), 0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+}
+
+TEST(Str, visit) {
+    auto count_spaces = [](auto view) {
+        py::ssize_t n = 0;
+        for (auto c : view) {
+            n += c == ' ';
+        }
+        return n;
+    };
+
+    for (const char *cs : {"a b c", "\xc3\xa9 b c", "\xe2\x82\xac b c",
+                           "\xf0\x9f\x98\x80 b c"}) {
+        auto s = py::str::object(std::string_view(cs)).as_tmpref();
+        ASSERT_NONNULL(s);
+        EXPECT_EQ(s.visit(count_spaces), 2) << cs;
+    }
+}
+
+TEST(Str, visit_kind_specialized) {
+    auto s = py::str::object(std::string_view("\xf0\x9f\x98\x80")).as_tmpref();
+    ASSERT_NONNULL(s);
+
+    std::size_t width = s.visit([](auto view) {
+        return sizeof(typename decltype(view)::value_type);
+    });
+    EXPECT_EQ(width, 4u);
+}
+
+TEST(Str, ostream) {
+    std::stringstream stream;
+    auto s = py::str::object(std::string_view("\xc3\xa9t\xc3\xa9")).as_tmpref();
+
+    stream << s;
+    EXPECT_EQ(stream.str(), "\xc3\xa9t\xc3\xa9");
+}
@@ -0,0 +1,108 @@
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include <Python.h>
+
+#include "libpy/libpy.h"
+#include "utils.h"
+
+using py::operator""_p;
+
+namespace {
+struct point {
+    int x;
+    int y;
+};
+
+std::ostream &operator<<(std::ostream &stream, const point &p) {
+    return stream << '(' << p.x << ", " << p.y << ')';
+}
+}
+
+TEST(StrWriter, empty) {
+    py::str_writer writer;
+    auto out = writer.finalize();
+    ASSERT_NONNULL(out);
+    EXPECT_TRUE((out == ""_p).istrue());
+}
+
+TEST(StrWriter, values) {
+    py::str_writer writer;
+    std::string s = "string";
+    writer << "ayy" << ' ' << std::string_view("lmao") << ' ' << s << ' '
+           << 1 << ' ' << -2L << ' ' << 3u << ' ' << 1.5 << ' ' << true << ' '
+           << point{1, 2};
+    ASSERT_TRUE(writer.is_nonnull());
+
+    auto out = writer.finalize();
+    ASSERT_NONNULL(out);
+    EXPECT_EQ(py::str::object(out).as_string_view(),
+              "ayy lmao string 1 -2 3 1.5 1 (1, 2)");
+}
+
+TEST(StrWriter, char_types) {
+    py::str_writer writer;
+    writer << 'a' << static_cast<signed char>('b')
+           << static_cast<unsigned char>('c') << std::uint8_t('d');
+    ASSERT_TRUE(writer.is_nonnull());
+
+    auto out = writer.finalize();
+    ASSERT_NONNULL(out);
+    EXPECT_EQ(py::str::object(out).as_string_view(), "abcd");
+}
+
+TEST(StrWriter, objects) {
+    py::str_writer writer;
+    writer << "ayy"_p << ' ' << 1_p << ' ' << py::None << ' '
+           << py::object(nullptr);
+    PyErr_Clear();
+
+    auto out = writer.finalize();
+    ASSERT_NONNULL(out);
+    EXPECT_EQ(py::str::object(out).as_string_view(), "ayy 1 None <NULL>");
+}
+
+TEST(StrWriter, non_ascii) {
+    py::str_writer writer;
+    writer << "ascii " << "\xc3\xa9t\xc3\xa9 " << "\xf0\x9f\x98\x80";
+    writer.put(0x20ac);
+
+    auto out = writer.finalize();
+    ASSERT_NONNULL(out);
+    py::str::object s(out);
+    EXPECT_EQ(s.as_string_view(),
+              "ascii \xc3\xa9t\xc3\xa9 \xf0\x9f\x98\x80\xe2\x82\xac");
+    EXPECT_EQ(s.len(), 12);
+    EXPECT_EQ(s.kind(), py::str::kind::ucs4);
+}
+
+TEST(StrWriter, invalid_utf8) {
+    py::str_writer writer;
+    EXPECT_NE(writer.write("\xff"), 0);
+    EXPECT_FALSE(writer.is_nonnull());
+    EXPECT_PYTHON_ERR(PyExc_UnicodeDecodeError);
+
+    // further writes are ignored
+    EXPECT_NE(writer.write("ayy"), 0);
+    EXPECT_IS(writer.finalize(), nullptr);
+    PyErr_Clear();
+
+    // the writer is usable again after finalize
+    EXPECT_TRUE(writer.is_nonnull());
+}
+
+TEST(StrWriter, reuse) {
+    py::str_writer writer(16);
+    writer << "ayy";
+    auto first = writer.finalize();
+    writer << "lmao";
+    auto second = writer.finalize();
+
+    ASSERT_NONNULL(first);
+    ASSERT_NONNULL(second);
+    EXPECT_EQ(py::str::object(first).as_string_view(), "ayy");
+    EXPECT_EQ(py::str::object(second).as_string_view(), "lmao");
+}
@@ -1,6 +1,10 @@
 #include <array>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
 #include <tuple>
 #include <typeinfo>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include <Python.h>
@@ -88,3 +92,354 @@ TEST(Tuple, from_iterable_pyobject) {
         EXPECT_IS(elem, expected[n++]);
     }
 }
+
+TEST(Tuple, from_iterable_list_and_tuple) {
+    auto expected = py::list::pack(0_p, 1_p, 2_p);
+    auto expected_tuple = py::tuple::from_iterable(expected);
+    ASSERT_NONNULL(expected_tuple);
+
+    for (const py::object &seq : {py::object(expected),
+                                  py::object(expected_tuple)}) {
+        auto ob = py::tuple::from_iterable(seq);
+        ASSERT_NONNULL(ob);
+        ASSERT_EQ(ob.len(), 3);
+
+        py::ssize_t n = 0;
+        for (const auto &elem : ob) {
+            EXPECT_IS(elem, expected[n++]);
+        }
+    }
+}
+
+TEST(Tuple, from_iterable_unsized) {
+    struct subtest {
+        const char *source;
+        py::ssize_t start;
+        py::ssize_t len;
+    };
+
+    for (const auto &subtest : {
+            subtest{"(n for n in range(100))", 0, 100},
+            subtest{"iter(range(100))", 0, 100},
+            // 0 is falsey so this has no useful length hint
+            subtest{"filter(None, range(100))", 1, 99},
+            subtest{"(n for n in range(0))", 0, 0}}) {
+        auto gen = eval(subtest.source);
+        ASSERT_NONNULL(gen);
+
+        auto ob = py::tuple::from_iterable(gen);
+        ASSERT_NONNULL(ob);
+        ASSERT_EQ(ob.len(), subtest.len) << subtest.source;
+
+        py::ssize_t n = subtest.start;
+        for (const auto &elem : ob) {
+            EXPECT_EQ(PyLong_AsSsize_t(elem), n++);
+        }
+    }
+}
+
+TEST(Tuple, from_iterable_raises) {
+    auto gen = eval("(1 // (5 - n) for n in range(10))");
+    ASSERT_NONNULL(gen);
+
+    EXPECT_IS(py::tuple::from_iterable(gen), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_ZeroDivisionError);
+
+    EXPECT_IS(py::tuple::from_iterable(1_p), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+}
+
+TEST(Tuple, from_range) {
+    std::vector<std::uint8_t> values = {7, 7, 255, 0};
+    auto ob = py::tuple::from_range(values);
+    ASSERT_NONNULL(ob);
+    ASSERT_EQ(ob.len(), 4);
+
+    for (std::size_t n = 0; n < values.size(); ++n) {
+        EXPECT_EQ(PyLong_AsLong(ob[n]), values[n]);
+    }
+    EXPECT_IS(ob[0], ob[1]);
+
+    double doubles[] = {0.5, 1.5};
+    auto double_tuple = py::tuple::from_range(doubles, 2);
+    ASSERT_NONNULL(double_tuple);
+    ASSERT_EQ(double_tuple.len(), 2);
+    EXPECT_EQ(PyFloat_AsDouble(double_tuple[0]), 0.5);
+    EXPECT_EQ(PyFloat_AsDouble(double_tuple[1]), 1.5);
+
+    std::vector<py::object> objects = {1_p, 1_p, 2_p};
+    auto object_tuple = py::tuple::from_range(objects);
+    ASSERT_NONNULL(object_tuple);
+    for (std::size_t n = 0; n < objects.size(); ++n) {
+        EXPECT_IS(object_tuple[n], objects[n]);
+    }
+}
+
+TEST(Tuple, to_vector) {
+    auto ob = eval("(True, False, True)");
+    ASSERT_NONNULL(ob);
+    py::tuple::object t(ob);
+
+    std::vector<bool> bools;
+    ASSERT_EQ(t.to_vector(bools), 0);
+    EXPECT_EQ(bools, (std::vector<bool>{true, false, true}));
+
+    std::vector<int> ints;
+    ASSERT_EQ(t.to_vector(ints), 0);
+    EXPECT_EQ(ints, (std::vector<int>{1, 0, 1}));
+
+    auto mixed = eval("(1, 0.5, __import__('fractions').Fraction(1, 4))");
+    ASSERT_NONNULL(mixed);
+    std::vector<double> doubles;
+    ASSERT_EQ(py::tuple::object(mixed).to_vector(doubles), 0);
+    EXPECT_EQ(doubles, (std::vector<double>{1.0, 0.5, 0.25}));
+
+    EXPECT_NE(py::tuple::object(mixed).to_vector(bools), 0);
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+}
+
+TEST(Tuple, to_vector_float) {
+    // just above a tie between two floats, but a double rounds it onto the
+    // tie which would then round down to even
+    auto ob = eval("(2 ** 60 + 2 ** 36 + 1, -(2 ** 60 + 2 ** 36 + 1), "
+                   "float('inf'))");
+    ASSERT_NONNULL(ob);
+    std::vector<float> floats;
+    ASSERT_EQ(py::tuple::object(ob).to_vector(floats), 0);
+    float expected = std::ldexp(1.0f, 60) + std::ldexp(1.0f, 37);
+    EXPECT_EQ(floats, (std::vector<float>{expected,
+                                          -expected,
+                                          INFINITY}));
+
+    for (const char *source : {"(10 ** 39,)", "(1e300,)"}) {
+        auto too_large = eval(source);
+        ASSERT_NONNULL(too_large);
+        EXPECT_NE(py::tuple::object(too_large).to_vector(floats), 0);
+        EXPECT_PYTHON_ERR(PyExc_OverflowError);
+    }
+}
+
+TEST(Tuple, to_vector_int_subclasses) {
+    // `__index__` returns these unchanged before Python 3.10
+    auto ob = eval(
+        "(True, __import__('enum').IntEnum('E', 'a b', module='test').b,"
+        " False)");
+    ASSERT_NONNULL(ob);
+    py::tuple::object t(ob);
+
+    std::vector<long> longs;
+    ASSERT_EQ(t.to_vector(longs), 0);
+    EXPECT_EQ(longs, (std::vector<long>{1, 2, 0}));
+
+    std::vector<unsigned char> bytes;
+    ASSERT_EQ(t.to_vector(bytes), 0);
+    EXPECT_EQ(bytes, (std::vector<unsigned char>{1, 2, 0}));
+
+    long value;
+    ASSERT_EQ(py::unbox(Py_True, value), 0);
+    EXPECT_EQ(value, 1);
+}
+
+TEST(Tuple, pack_raw_pointers) {
+    PyObject *a = Py_None;
+    PyObject *b = Py_True;
+    Py_ssize_t start = Py_REFCNT(a);
+
+    auto t = py::tuple::pack(a, b);
+    ASSERT_NONNULL(t);
+    EXPECT_EQ(Py_REFCNT(a), start + 1);
+    EXPECT_IS(t[0], Py_None);
+    EXPECT_IS(t[1], Py_True);
+
+    auto l = py::list::pack(a, 1_p);
+    ASSERT_NONNULL(l);
+    EXPECT_IS(l[0], Py_None);
+    EXPECT_IS(l[1], 1_p);
+
+    PyObject *null = nullptr;
+    EXPECT_IS(py::tuple::pack(a, null), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_AssertionError);
+    EXPECT_IS(py::list::pack(null), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_AssertionError);
+}
+
+TEST(Tuple, pack_references) {
+    auto a = eval("object()");
+    ASSERT_NONNULL(a);
+    py::ssize_t start = Py_REFCNT(a);
+
+    {
+        // lvalues are increfed
+        auto t = py::tuple::pack(a, a);
+        ASSERT_NONNULL(t);
+        EXPECT_EQ(Py_REFCNT(a), start + 2);
+        EXPECT_IS(t[0], a);
+        EXPECT_IS(t[1], a);
+    }
+    EXPECT_EQ(Py_REFCNT(a), start);
+
+    {
+        // rvalue tmprefs give up their reference
+        py::tmpref<py::object> b(a);
+        ASSERT_EQ(Py_REFCNT(a), start + 1);
+        auto t = py::tuple::pack(std::move(b), 1_p);
+        ASSERT_NONNULL(t);
+        EXPECT_IS(b, nullptr);
+        EXPECT_EQ(Py_REFCNT(a), start + 1);
+        EXPECT_IS(t[0], a);
+        EXPECT_IS(t[1], 1_p);
+    }
+    EXPECT_EQ(Py_REFCNT(a), start);
+
+    {
+        auto t = py::tuple::pack(a.str(), 1_p);
+        ASSERT_NONNULL(t);
+        EXPECT_EQ(Py_REFCNT(t[0]), 1);
+    }
+
+    EXPECT_IS(py::tuple::pack(a, py::object()), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_AssertionError);
+}
+
+TEST(Tuple, slice) {
+    auto ob = eval("tuple(range(10))");
+    ASSERT_NONNULL(ob);
+    py::tuple::object t(ob);
+
+    struct subtest {
+        py::ssize_t start;
+        py::ssize_t stop;
+        py::ssize_t step;
+        const char *expected;
+    };
+
+    for (const auto &subtest : {
+            subtest{2, 5, 1, "t[2:5]"},
+            subtest{-3, py::slice_end, 1, "t[-3:]"},
+            subtest{0, py::slice_end, 3, "t[::3]"},
+            subtest{-1, py::slice_end, -1, "t[::-1]"},
+            subtest{8, 2, -2, "t[8:2:-2]"},
+            subtest{20, 30, 1, "t[20:30]"},
+            subtest{-20, 2, 1, "t[-20:2]"},
+            subtest{5, 2, 1, "t[5:2]"},
+            subtest{-100, py::slice_end, -1, "t[-100::-1]"},
+            subtest{-100, -200, -1, "t[-100:-200:-1]"},
+            subtest{2, 5, -1, "t[2:5:-1]"}}) {
+        py::tmpref<py::object> code(Py_CompileString(
+            subtest.expected, "<test>", Py_eval_input));
+        ASSERT_NONNULL(code);
+        py::tmpref<py::object> globals(PyDict_New());
+        ASSERT_EQ(PyDict_SetItemString(globals, "t", t), 0);
+        py::tmpref<py::object> expected(
+            PyEval_EvalCode(code, globals, globals));
+        ASSERT_NONNULL(expected);
+
+        auto span = t.slice(subtest.start, subtest.stop, subtest.step);
+        ASSERT_TRUE(span.is_nonnull());
+        ASSERT_EQ(span.size(), PyTuple_GET_SIZE(expected.operator PyObject*()))
+            << subtest.expected;
+        py::ssize_t n = 0;
+        for (const py::object &item : span) {
+            EXPECT_IS(item, PyTuple_GET_ITEM(
+                          expected.operator PyObject*(), n++));
+        }
+
+        auto copy = t.slice_copy(subtest.start, subtest.stop, subtest.step);
+        ASSERT_NONNULL(copy);
+        EXPECT_TRUE((copy == expected).istrue()) << subtest.expected;
+    }
+
+    // a full copy of a tuple is the tuple itself
+    EXPECT_IS(t.slice_copy(0), t);
+
+    auto span = t.slice<-3>();
+    ASSERT_EQ(span.size(), 3);
+    EXPECT_EQ(PyLong_AsLong(span[0]), 7);
+    EXPECT_EQ((t.slice<1, -1, 4>().size()), 2);
+    EXPECT_EQ(t.slice<20>().size(), 0);
+    EXPECT_EQ((t.slice<-1, py::slice_end, -1>().size()), 10);
+
+    EXPECT_EQ(PyLong_AsLong(t.at<-1>()), 9);
+    EXPECT_EQ(PyLong_AsLong(t.at<0>()), 0);
+    EXPECT_IS(t.at<10>(), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_IndexError);
+    EXPECT_IS(t.at<-11>(), nullptr);
+    EXPECT_PYTHON_ERR(PyExc_IndexError);
+
+    EXPECT_FALSE(t.slice(0, 1, 0).is_nonnull());
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+
+    // an empty result does not point before the items
+    auto empty = t.slice(-100, py::slice_end, -1);
+    ASSERT_TRUE(empty.is_nonnull());
+    EXPECT_EQ(empty.size(), 0);
+    EXPECT_TRUE(empty.begin() == empty.end());
+}
+
+TEST(Tuple, slice_iterator) {
+    auto ob = eval("tuple(range(10))");
+    ASSERT_NONNULL(ob);
+    py::tuple::object t(ob);
+
+    // t[::-2] is (9, 7, 5, 3, 1)
+    auto span = t.slice(-1, py::slice_end, -2);
+    ASSERT_TRUE(span.is_nonnull());
+    auto first = span.begin();
+    auto last = span.end();
+    ASSERT_EQ(last - first, 5);
+    EXPECT_TRUE(first < last);
+    EXPECT_TRUE(last >= first);
+    EXPECT_EQ(PyLong_AsLong(first[2]), 5);
+    EXPECT_EQ(PyLong_AsLong(*(2 + first)), 5);
+
+    auto it = last;
+    --it;
+    EXPECT_EQ(PyLong_AsLong(*it), 1);
+    it -= 3;
+    EXPECT_EQ(PyLong_AsLong(*it), 7);
+    EXPECT_EQ(PyLong_AsLong(*it--), 7);
+    EXPECT_TRUE(it == first);
+    EXPECT_EQ(PyLong_AsLong(*(last - 1)), 1);
+
+    std::vector<long> reversed;
+    for (auto rit = std::make_reverse_iterator(last);
+         rit != std::make_reverse_iterator(first);
+         ++rit) {
+        reversed.push_back(PyLong_AsLong(*rit));
+    }
+    EXPECT_EQ(reversed, (std::vector<long>{1, 3, 5, 7, 9}));
+}
+
+TEST(Tuple, unpack) {
+    auto ob = eval("(1, 2.5, 'c')");
+    ASSERT_NONNULL(ob);
+    py::tuple::object t(ob);
+
+    auto [a, b, c] = t.unpack<3>();
+    EXPECT_IS(a, 1_p);
+    EXPECT_EQ(PyFloat_AsDouble(b), 2.5);
+    EXPECT_TRUE((c == eval("'c'")).istrue());
+
+    auto wrong = t.unpack<2>();
+    EXPECT_IS(wrong[0], nullptr);
+    EXPECT_IS(wrong[1], nullptr);
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+
+    auto row = t.unpack<long, double, py::object>();
+    ASSERT_TRUE(row.has_value());
+    auto [x, y, z] = *row;
+    EXPECT_EQ(x, 1);
+    EXPECT_EQ(y, 2.5);
+    EXPECT_IS(z, c);
+
+    // ints are converted to floats, but not the other way
+    ASSERT_TRUE((t.unpack<double, double, py::object>().has_value()));
+    EXPECT_FALSE((t.unpack<long, long, py::object>().has_value()));
+    EXPECT_PYTHON_ERR(PyExc_TypeError);
+
+    EXPECT_FALSE((t.unpack<long, double>().has_value()));
+    EXPECT_PYTHON_ERR(PyExc_ValueError);
+
+    EXPECT_FALSE((py::tuple::object().unpack<long>().has_value()));
+    EXPECT_PYTHON_ERR(PyExc_AssertionError);
+}
@@ -2,6 +2,8 @@
 #include <cstdlib>
 #include <cxxabi.h>
 
+#include "utils.h"
+
 std::string demangle(const char *name) {
     int status;
     char *cs = abi::__cxa_demangle(name, 0, 0, &status);
@@ -9,3 +11,12 @@ std::string demangle(const char *name) {
     free(cs);
     return ret;
 }
+
+py::tmpref<py::object> eval(const char *source) {
+    py::tmpref<py::object> globals(PyDict_New());
+    if (!globals.is_nonnull() ||
+        PyDict_SetItemString(globals, "__builtins__", PyEval_GetBuiltins())) {
+        return nullptr;
+    }
+    return PyRun_String(source, Py_eval_input, globals, globals);
+}
@@ -76,3 +76,11 @@
    @return     The demangled named.
 */
 std::string demangle(const char *name);
+
+/**
+   Evaluate a Python expression with only the builtins in scope.
+
+   @param source The expression to evaluate.
+   @return       The result of the expression or `nullptr`.
+*/
+py::tmpref<py::object> eval(const char *source);